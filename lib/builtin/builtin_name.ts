@@ -11,9 +11,6 @@ export namespace BuiltinNames {
     export const stackPointer = '__stack_pointer';
     export const heapBase = '__heap_base';
 
-    // wasm table
-    export const extrefTable = 'extref_table';
-
     // wasm default variable
     export const byteSize = 32;
     export const stackSize = 1024;
@@ -21,7 +18,6 @@ export namespace BuiltinNames {
     export const memMaximumPages = 10;
     export const tableInitialPages = 1;
     export const tableMaximumPages = 10;
-    export const tableGrowDelta = 10;
     export const memoryReserveOffset = 0;
     export const memoryReserveMaxSize = 100;
 
@@ -130,8 +126,6 @@ export namespace BuiltinNames {
     export const stringtrimFuncName = 'String|trim';
     export const anyrefCond = 'anyrefCond';
     export const newExtRef = 'newExtRef';
-    export const allocExtRefTableSlot = 'allocExtRefTableSlot';
-    export const extRefTableMaskArr = 'extRefTableMaskArr';
     export const percent = 'percent';
     export const getPropertyIfTypeIdMismatch =
         'get_property_if_typeid_mismatch';
@@ -5,9 +5,31 @@
 
 #include "type.h"
 #include "pure_dynamic.h"
+#include "libdyntype_export.h"
 
 static dyn_ctx_t g_dynamic_context = NULL;
 
+static void
+extref_finalizer(JSRuntime *rt, JSValue val)
+{
+    DynExtRef *extref = JS_GetOpaque(val, g_dynamic_context->extref_class_id);
+    dyntype_extref_finalizer_t finalizer = dyntype_get_extref_finalizer();
+
+    if (!extref) {
+        return;
+    }
+
+    if (finalizer) {
+        finalizer(dyntype_context_get_exec_env(), extref->ref);
+    }
+    js_free_rt(rt, extref);
+}
+
+static JSClassDef extref_class_def = {
+    .class_name = "ExtRef",
+    .finalizer = extref_finalizer,
+};
+
 JSValue *
 dynamic_dup_value(JSContext *ctx, JSValue value)
 {
@@ -20,6 +42,219 @@ dynamic_dup_value(JSContext *ctx, JSValue value)
     return ptr;
 }
 
+/******************* Temporary values *****************/
+
+/* Temporary values are stored in fixed size chunks, so their addresses stay
+ * valid when more chunks are added. The chunks are kept for reuse until the
+ * context is destroyed. */
+dyn_value_t
+dynamic_new_temp_value(dyn_ctx_t ctx, JSValue value)
+{
+    uint32_t chunk_idx = ctx->temp_top / DYN_TEMP_CHUNK_SIZE;
+    JSValue **chunks, *ptr;
+
+    if (chunk_idx >= ctx->temp_chunk_count) {
+        chunks = js_realloc(ctx->js_ctx, ctx->temp_chunks,
+                            sizeof(JSValue *) * (chunk_idx + 1));
+        if (!chunks) {
+            return NULL;
+        }
+        ctx->temp_chunks = chunks;
+
+        chunks[chunk_idx] =
+            js_malloc(ctx->js_ctx, sizeof(JSValue) * DYN_TEMP_CHUNK_SIZE);
+        if (!chunks[chunk_idx]) {
+            return NULL;
+        }
+        ctx->temp_chunk_count = chunk_idx + 1;
+    }
+
+    ptr = &ctx->temp_chunks[chunk_idx][ctx->temp_top % DYN_TEMP_CHUNK_SIZE];
+    *ptr = value;
+    ctx->temp_top++;
+    return ptr;
+}
+
+dyn_value_t
+dynamic_move_to_temp(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    JSValue *ptr = (JSValue *)obj;
+    dyn_value_t res;
+
+    if (!obj) {
+        return NULL;
+    }
+
+    if (obj == ctx->js_undefined || obj == ctx->js_null) {
+        return obj;
+    }
+
+    res = dynamic_new_temp_value(ctx, *ptr);
+    if (!res) {
+        /* keep the heap value, the caller still owns it */
+        return NULL;
+    }
+    js_free(ctx->js_ctx, ptr);
+    return res;
+}
+
+uint32_t
+dynamic_temp_scope_begin(dyn_ctx_t ctx)
+{
+    return ctx->temp_top;
+}
+
+void
+dynamic_temp_scope_end(dyn_ctx_t ctx, uint32_t scope)
+{
+    uint32_t idx;
+
+    while (ctx->temp_top > scope) {
+        idx = --ctx->temp_top;
+        JS_FreeValue(ctx->js_ctx, ctx->temp_chunks[idx / DYN_TEMP_CHUNK_SIZE]
+                                                  [idx % DYN_TEMP_CHUNK_SIZE]);
+    }
+}
+
+/******************* Global variable cache *****************/
+
+static void
+clear_global_cache_entry(dyn_ctx_t ctx, DynGlobalCacheEntry *entry)
+{
+    if (entry->name) {
+        js_free(ctx->js_ctx, entry->name);
+        JS_FreeAtom(ctx->js_ctx, entry->atom);
+    }
+    memset(entry, 0, sizeof(DynGlobalCacheEntry));
+}
+
+JSValue
+dynamic_lookup_global(dyn_ctx_t ctx, const char *name)
+{
+    uint32_t slot = (uint32_t)(((uintptr_t)name * 2654435761u) >> 8)
+                    % DYN_GLOBAL_CACHE_SIZE;
+    DynGlobalCacheEntry *entry = &ctx->global_cache[slot];
+    JSAtom atom;
+    JSValue value;
+    char *name_copy;
+    size_t len;
+
+    if (entry->name_addr == name && strcmp(entry->name, name) == 0) {
+        return JS_GetGlobalVar(ctx->js_ctx, entry->atom, true);
+    }
+
+    atom = find_atom(ctx->js_ctx, name);
+    value = JS_GetGlobalVar(ctx->js_ctx, atom, true);
+    if (JS_IsException(value)) {
+        JS_FreeAtom(ctx->js_ctx, atom);
+        return value;
+    }
+
+    len = strlen(name);
+    if ((name_copy = js_malloc(ctx->js_ctx, len + 1))) {
+        memcpy(name_copy, name, len + 1);
+        clear_global_cache_entry(ctx, entry);
+        entry->name_addr = name;
+        entry->name = name_copy;
+        /* the entry takes the reference of the atom */
+        entry->atom = atom;
+    }
+    else {
+        JS_FreeAtom(ctx->js_ctx, atom);
+    }
+
+    return value;
+}
+
+/******************* Instanceof cache *****************/
+
+static void
+clear_instanceof_cache(dyn_ctx_t ctx)
+{
+    DynInstanceOfCacheEntry *entry;
+    uint32_t i;
+
+    for (i = 0; i < DYN_INSTANCEOF_CACHE_SIZE; i++) {
+        entry = &ctx->instanceof_cache[i];
+        if (JS_IsObject(entry->ctor)) {
+            JS_FreeValue(ctx->js_ctx, entry->proto);
+            JS_FreeValue(ctx->js_ctx, entry->ctor);
+        }
+        memset(entry, 0, sizeof(DynInstanceOfCacheEntry));
+    }
+}
+
+static inline DynInstanceOfCacheEntry *
+get_instanceof_cache_entry(dyn_ctx_t ctx, JSValue proto, JSValue ctor)
+{
+    uintptr_t key = (uintptr_t)JS_VALUE_GET_PTR(proto)
+                    ^ ((uintptr_t)JS_VALUE_GET_PTR(ctor) >> 4);
+    uint32_t slot =
+        (uint32_t)((key * 2654435761u) >> 8) % DYN_INSTANCEOF_CACHE_SIZE;
+
+    return &ctx->instanceof_cache[slot];
+}
+
+/* The result only depends on the prototype chain of the object and on the
+ * "prototype" property of the constructor, so it is cached by the first
+ * prototype of the object. Returns -1 on exception, like
+ * JS_OrdinaryIsInstanceOf1. */
+int
+dynamic_lookup_instanceof(dyn_ctx_t ctx, JSValue obj, JSValue ctor)
+{
+    DynInstanceOfCacheEntry *entry;
+    JSValue proto;
+    int ret;
+
+    if (!JS_IsObject(obj) || !JS_IsObject(ctor)) {
+        return JS_OrdinaryIsInstanceOf1(ctx->js_ctx, obj, ctor);
+    }
+
+    /* the prototype is returned with its reference count bumped */
+    proto = JS_GetPrototype(ctx->js_ctx, obj);
+    if (!JS_IsObject(proto)) {
+        JS_FreeValue(ctx->js_ctx, proto);
+        return JS_OrdinaryIsInstanceOf1(ctx->js_ctx, obj, ctor);
+    }
+
+    entry = get_instanceof_cache_entry(ctx, proto, ctor);
+    if (JS_IsObject(entry->ctor)
+        && JS_VALUE_GET_PTR(entry->proto) == JS_VALUE_GET_PTR(proto)
+        && JS_VALUE_GET_PTR(entry->ctor) == JS_VALUE_GET_PTR(ctor)) {
+        JS_FreeValue(ctx->js_ctx, proto);
+        return entry->result;
+    }
+
+    ret = JS_OrdinaryIsInstanceOf1(ctx->js_ctx, obj, ctor);
+    if (ret < 0) {
+        JS_FreeValue(ctx->js_ctx, proto);
+        return ret;
+    }
+
+    if (JS_IsObject(entry->ctor)) {
+        JS_FreeValue(ctx->js_ctx, entry->proto);
+        JS_FreeValue(ctx->js_ctx, entry->ctor);
+    }
+    /* the reference of proto is moved into the entry */
+    entry->proto = proto;
+    entry->ctor = JS_DupValue(ctx->js_ctx, ctor);
+    entry->result = ret == 1;
+
+    return ret;
+}
+
+/* prop is the name of the written property, or NULL if the prototype of an
+ * object is replaced */
+void
+dynamic_invalidate_instanceof_cache(dyn_ctx_t ctx, const char *prop)
+{
+    if (prop && strcmp(prop, "prototype") != 0) {
+        return;
+    }
+
+    clear_instanceof_cache(ctx);
+}
+
 /******************* Initialization and destroy *****************/
 
 dyn_ctx_t
@@ -59,8 +294,24 @@ dynamic_context_init()
 
     class_id = 0;
     ctx->extref_class_id = JS_NewClassID(&class_id);
+    if (JS_NewClass(ctx->js_rt, ctx->extref_class_id, &extref_class_def)) {
+        goto fail;
+    }
+    /* keep Object.prototype in the prototype chain of extref objects */
+    JS_SetClassProto(ctx->js_ctx, ctx->extref_class_id,
+                     JS_NewObject(ctx->js_ctx));
 
-    (void)class_id;
+    ctx->extref_atom = JS_NewAtom(ctx->js_ctx, "@ref");
+    if (ctx->extref_atom == JS_ATOM_NULL) {
+        goto fail;
+    }
+
+    ctx->length_atom = JS_NewAtom(ctx->js_ctx, "length");
+    if (ctx->length_atom == JS_ATOM_NULL) {
+        goto fail;
+    }
+
+    ctx->global_obj = JS_GetGlobalObject(ctx->js_ctx);
 
     g_dynamic_context = ctx;
     return ctx;
@@ -80,13 +331,42 @@ dynamic_context_init_with_opt(dyn_options_t *options)
 void
 dynamic_context_destroy(dyn_ctx_t ctx)
 {
+    uint32_t i;
+
     if (ctx) {
+        for (i = 0; i < DYN_GLOBAL_CACHE_SIZE; i++) {
+            clear_global_cache_entry(ctx, &ctx->global_cache[i]);
+        }
+        clear_instanceof_cache(ctx);
+        JS_FreeValue(ctx->js_ctx, ctx->wtf8_cursor.str);
+        for (i = 0; i < DYN_STRING_CONST_CACHE_SIZE; i++) {
+            if (ctx->string_const_cache[i].bytes) {
+                js_free(ctx->js_ctx, ctx->string_const_cache[i].bytes);
+                JS_FreeValue(ctx->js_ctx, ctx->string_const_cache[i].str);
+            }
+        }
+        if (JS_IsObject(ctx->global_obj)) {
+            JS_FreeValue(ctx->js_ctx, ctx->global_obj);
+        }
+        if (ctx->temp_chunks) {
+            dynamic_temp_scope_end(ctx, 0);
+            for (i = 0; i < ctx->temp_chunk_count; i++) {
+                js_free(ctx->js_ctx, ctx->temp_chunks[i]);
+            }
+            js_free(ctx->js_ctx, ctx->temp_chunks);
+        }
         if (ctx->js_undefined) {
             js_free(ctx->js_ctx, ctx->js_undefined);
         }
         if (ctx->js_null) {
             js_free(ctx->js_ctx, ctx->js_null);
         }
+        if (ctx->extref_atom != JS_ATOM_NULL) {
+            JS_FreeAtom(ctx->js_ctx, ctx->extref_atom);
+        }
+        if (ctx->length_atom != JS_ATOM_NULL) {
+            JS_FreeAtom(ctx->js_ctx, ctx->length_atom);
+        }
         if (ctx->js_ctx) {
             JS_FreeContext(ctx->js_ctx);
         }
@@ -6,10 +6,16 @@
 #include "libdyntype_export.h"
 #include "quickjs.h"
 #include "type.h"
+#if WASM_ENABLE_STRINGREF != 0
+#include "stringref_qjs.h"
+#endif
 
 extern JSValue *
 dynamic_dup_value(JSContext *ctx, JSValue value);
 
+extern dyn_value_t
+dynamic_new_temp_value(dyn_ctx_t ctx, JSValue value);
+
 /******************* builtin type compare *******************/
 static inline bool
 number_cmp(double lhs, double rhs, cmp_operator operator_kind)
@@ -184,9 +190,11 @@ WasmCallBackDataForJS(JSContext *ctx, JSValueConst this_obj, int argc,
                       JSValueConst *argv, int magic, JSValue *func_data)
 {
     JSValue ret;
-    void *vfunc = JS_GetOpaque(func_data[0], JS_CLASS_OBJECT);
     void *exec_env = JS_GetOpaque(func_data[1], JS_CLASS_OBJECT);
     dyn_ctx_t dyntype_ctx = JS_GetOpaque(func_data[2], JS_CLASS_OBJECT);
+    DynExtRef *extref =
+        JS_GetOpaque(func_data[0], dyntype_ctx->extref_class_id);
+    void *vfunc = extref->ref;
     dyn_value_t *args = NULL;
     dyn_value_t this_dyn_obj = NULL;
     uint64_t total_size;
@@ -232,11 +240,10 @@ WasmCallBackDataForJS(JSContext *ctx, JSValueConst this_obj, int argc,
 }
 
 static JSValue
-new_function_wrapper(dyn_ctx_t ctx, void *vfunc, void *opaque)
+new_function_wrapper(dyn_ctx_t ctx, JSValue ref_obj, void *opaque)
 {
     JSValue data_hold[3];
-    data_hold[0] = JS_NewObject(ctx->js_ctx);
-    JS_SetOpaque(data_hold[0], vfunc);
+    data_hold[0] = JS_DupValue(ctx->js_ctx, ref_obj);
     data_hold[1] = JS_NewObject(ctx->js_ctx);
     JS_SetOpaque(data_hold[1], opaque);
     data_hold[2] = JS_NewObject(ctx->js_ctx);
@@ -270,7 +277,13 @@ dynamic_new_boolean(dyn_ctx_t ctx, bool value)
 dyn_value_t
 dynamic_new_string(dyn_ctx_t ctx, const void *stringref)
 {
-    JSValue js_str = JS_MKPTR(JS_TAG_STRING, (void *)stringref);
+    void *str = wasm_string_flatten(stringref);
+    JSValue js_str;
+
+    if (!str) {
+        return NULL;
+    }
+    js_str = JS_MKPTR(JS_TAG_STRING, str);
     return dynamic_dup_value(ctx->js_ctx, JS_DupValue(ctx->js_ctx, js_str));
 }
 #else
@@ -336,13 +349,11 @@ dynamic_new_array(dyn_ctx_t ctx, int len)
 dyn_value_t
 dynamic_get_global(dyn_ctx_t ctx, const char *name)
 {
-    JSAtom atom = find_atom(ctx->js_ctx, name);
-    JSValue global_var = JS_GetGlobalVar(ctx->js_ctx, atom, true);
+    JSValue global_var = dynamic_lookup_global(ctx, name);
 
     if (JS_IsException(global_var)) {
         return NULL;
     }
-    JS_FreeAtom(ctx->js_ctx, atom);
     return dynamic_dup_value(ctx->js_ctx, global_var);
 }
 
@@ -351,8 +362,7 @@ dynamic_new_object_with_class(dyn_ctx_t ctx, const char *name, int argc,
                               dyn_value_t *args)
 {
     JSValue obj;
-    JSAtom atom = find_atom(ctx->js_ctx, name);
-    JSValue global_var = JS_GetGlobalVar(ctx->js_ctx, atom, true);
+    JSValue global_var = dynamic_lookup_global(ctx, name);
     JSValue *argv = NULL;
     dyn_value_t res = NULL;
     uint64_t total_size;
@@ -379,7 +389,6 @@ dynamic_new_object_with_class(dyn_ctx_t ctx, const char *name, int argc,
     res = dynamic_dup_value(ctx->js_ctx, obj);
 
 end:
-    JS_FreeAtom(ctx->js_ctx, atom);
     JS_FreeValue(ctx->js_ctx, global_var);
 
     if (argv) {
@@ -392,27 +401,45 @@ end:
 dyn_value_t
 dynamic_new_extref(dyn_ctx_t ctx, void *ptr, external_ref_tag tag, void *opaque)
 {
-    JSValue tag_v, ref_v, v;
+    JSValue ref_obj, v;
+    DynExtRef *extref;
 
     if (tag != ExtObj && tag != ExtFunc && tag != ExtArray) {
         return NULL;
     }
 
-    if (tag == ExtFunc) {
-        v = new_function_wrapper(ctx, ptr, opaque);
-    }
-    else {
-        v = JS_NewObject(ctx->js_ctx);
+    extref = js_malloc(ctx->js_ctx, sizeof(DynExtRef));
+    if (!extref) {
+        return NULL;
     }
+    extref->ref = ptr;
+    extref->tag = tag;
 
-    if (JS_IsException(v)) {
+    ref_obj = JS_NewObjectClass(ctx->js_ctx, ctx->extref_class_id);
+    if (JS_IsException(ref_obj)) {
+        js_free(ctx->js_ctx, extref);
         return NULL;
     }
 
-    tag_v = JS_NewInt32(ctx->js_ctx, (int)tag);
-    ref_v = JS_NewInt32(ctx->js_ctx, (int32_t)(uintptr_t)ptr);
-    JS_DefinePropertyValueStr(ctx->js_ctx, v, "@tag", tag_v, 0);
-    JS_DefinePropertyValueStr(ctx->js_ctx, v, "@ref", ref_v, 0);
+    if (tag == ExtFunc) {
+        v = new_function_wrapper(ctx, ref_obj, opaque);
+        if (JS_IsException(v)
+            || JS_DefinePropertyValue(ctx->js_ctx, v, ctx->extref_atom,
+                                      JS_DupValue(ctx->js_ctx, ref_obj), 0)
+                   < 0) {
+            JS_FreeValue(ctx->js_ctx, v);
+            JS_FreeValue(ctx->js_ctx, ref_obj);
+            js_free(ctx->js_ctx, extref);
+            return NULL;
+        }
+        JS_FreeValue(ctx->js_ctx, ref_obj);
+    }
+    else {
+        v = ref_obj;
+    }
+
+    /* set at last so the finalizer only sees fully created extrefs */
+    JS_SetOpaque(ref_obj, extref);
     return dynamic_dup_value(ctx->js_ctx, v);
 }
 
@@ -455,6 +482,28 @@ dynamic_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
     return dynamic_dup_value(ctx->js_ctx, val);
 }
 
+dyn_value_t
+dynamic_get_elem_temp(dyn_ctx_t ctx, dyn_value_t obj, int index)
+{
+    JSValue val;
+    JSValue *obj_ptr = (JSValue *)obj;
+    dyn_value_t res;
+
+    if (!JS_IsArray(ctx->js_ctx, *obj_ptr)) {
+        return NULL;
+    }
+    if (index < 0)
+        return dynamic_new_undefined(ctx);
+    val = JS_GetPropertyUint32(ctx->js_ctx, *obj_ptr, index);
+    if (JS_IsException(val)) {
+        return NULL;
+    }
+    if (!(res = dynamic_new_temp_value(ctx, val))) {
+        JS_FreeValue(ctx->js_ctx, val);
+    }
+    return res;
+}
+
 int
 dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
                      dyn_value_t value)
@@ -466,6 +515,7 @@ dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
     if (!JS_IsObject(*obj_ptr)) {
         return -DYNTYPE_TYPEERR;
     }
+    dynamic_invalidate_instanceof_cache(ctx, prop);
     val = (JSValue *)value;
     ret = JS_SetPropertyStr(ctx->js_ctx, *obj_ptr, prop,
                             JS_DupValue(ctx->js_ctx, *val))
@@ -491,6 +541,7 @@ dynamic_define_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
         return -DYNTYPE_TYPEERR;
     }
 
+    dynamic_invalidate_instanceof_cache(ctx, prop);
     atom = JS_NewAtom(ctx->js_ctx, prop);
     if (atom == JS_ATOM_NULL) {
         return -DYNTYPE_EXCEPTION;
@@ -557,6 +608,7 @@ dynamic_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
         return -DYNTYPE_FALSE;
     }
 
+    dynamic_invalidate_instanceof_cache(ctx, prop);
     atom = JS_NewAtom(ctx->js_ctx, prop);
     if (atom == JS_ATOM_NULL) {
         return -DYNTYPE_EXCEPTION;
@@ -663,12 +715,121 @@ dynamic_to_cstring(dyn_ctx_t ctx, dyn_value_t str_obj, char **pres)
     return DYNTYPE_SUCCESS;
 }
 
+int
+dynamic_to_cstring_len(dyn_ctx_t ctx, dyn_value_t str_obj, char **pres,
+                       uint32_t *plen)
+{
+    JSValue *ptr = (JSValue *)str_obj;
+    size_t len = 0;
+
+    /* the length is returned by quickjs, no need to strlen the result */
+    *pres = (char *)JS_ToCStringLen(ctx->js_ctx, &len, *ptr);
+    if (*pres == NULL) {
+        return -DYNTYPE_EXCEPTION;
+    }
+    *plen = (uint32_t)len;
+    return DYNTYPE_SUCCESS;
+}
+
+bool
+dynamic_encode_string_utf8(dyn_ctx_t ctx, dyn_value_t str_obj, char *buf,
+                           uint32_t *plen)
+{
+    JSValue *ptr = (JSValue *)str_obj;
+    QJSString *str;
+    uint32_t i, c, c2, len = 0;
+
+    if (!JS_IsString(*ptr)) {
+        return false;
+    }
+    str = JS_VALUE_GET_PTR(*ptr);
+
+    if (!str->is_wide_char) {
+        for (i = 0; i < str->len; i++) {
+            len += str->u.str8[i] < 0x80 ? 1 : 2;
+        }
+        if (buf && len == str->len) {
+            /* ASCII, copied as is */
+            memcpy(buf, str->u.str8, len);
+        }
+        else if (buf) {
+            for (i = 0; i < str->len; i++) {
+                c = str->u.str8[i];
+                if (c < 0x80) {
+                    *buf++ = (char)c;
+                }
+                else {
+                    *buf++ = (char)(0xC0 | (c >> 6));
+                    *buf++ = (char)(0x80 | (c & 0x3F));
+                }
+            }
+        }
+        *plen = len;
+        return true;
+    }
+
+    /* a lone surrogate is encoded in 3 bytes like JS_ToCStringLen */
+    for (i = 0; i < str->len; i++) {
+        c = str->u.str16[i];
+        if (c >= 0xD800 && c < 0xDC00 && i + 1 < str->len
+            && (c2 = str->u.str16[i + 1]) >= 0xDC00 && c2 < 0xE000) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00);
+            i++;
+        }
+
+        if (c < 0x80) {
+            if (buf) {
+                buf[len] = (char)c;
+            }
+            len += 1;
+        }
+        else if (c < 0x800) {
+            if (buf) {
+                buf[len] = (char)(0xC0 | (c >> 6));
+                buf[len + 1] = (char)(0x80 | (c & 0x3F));
+            }
+            len += 2;
+        }
+        else if (c < 0x10000) {
+            if (buf) {
+                buf[len] = (char)(0xE0 | (c >> 12));
+                buf[len + 1] = (char)(0x80 | ((c >> 6) & 0x3F));
+                buf[len + 2] = (char)(0x80 | (c & 0x3F));
+            }
+            len += 3;
+        }
+        else {
+            if (buf) {
+                buf[len] = (char)(0xF0 | (c >> 18));
+                buf[len + 1] = (char)(0x80 | ((c >> 12) & 0x3F));
+                buf[len + 2] = (char)(0x80 | ((c >> 6) & 0x3F));
+                buf[len + 3] = (char)(0x80 | (c & 0x3F));
+            }
+            len += 4;
+        }
+    }
+
+    *plen = len;
+    return true;
+}
+
 void
 dynamic_free_cstring(dyn_ctx_t ctx, char *str)
 {
     JS_FreeCString(ctx->js_ctx, (const char *)str);
 }
 
+const void *
+dynamic_get_string_id(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    JSValue *ptr = (JSValue *)obj;
+
+    if (!JS_IsString(*ptr)) {
+        return NULL;
+    }
+    return JS_VALUE_GET_PTR(*ptr);
+}
+
 bool
 dynamic_is_object(dyn_ctx_t ctx, dyn_value_t obj)
 {
@@ -690,37 +851,46 @@ dynamic_is_array(dyn_ctx_t ctx, dyn_value_t obj)
     return (bool)JS_IsArray(ctx->js_ctx, *ptr);
 }
 
+static DynExtRef *
+get_extref(dyn_ctx_t ctx, JSValueConst v)
+{
+    DynExtRef *extref;
+    JSValue ref_obj;
+
+    if (!JS_IsObject(v)) {
+        return NULL;
+    }
+
+    extref = JS_GetOpaque(v, ctx->extref_class_id);
+    if (extref || !JS_IsFunction(ctx->js_ctx, v)) {
+        return extref;
+    }
+
+    /* ExtFunc is a function wrapper holding the extref object */
+    ref_obj = JS_GetProperty(ctx->js_ctx, v, ctx->extref_atom);
+    extref = JS_GetOpaque(ref_obj, ctx->extref_class_id);
+    JS_FreeValue(ctx->js_ctx, ref_obj);
+
+    return extref;
+}
+
 bool
 dynamic_is_extref(dyn_ctx_t ctx, dyn_value_t obj)
 {
-    if (!dynamic_is_object(ctx, obj)) {
-        return false;
-    }
-    return dynamic_has_property(ctx, obj, "@tag") == DYNTYPE_TRUE ? true
-                                                                  : false;
+    return get_extref(ctx, *(JSValue *)obj) != NULL;
 }
 
 int
 dynamic_to_extref(dyn_ctx_t ctx, dyn_value_t obj, void **pres)
 {
-    JSValue *ref_v;
-    JSValue *tag_v;
-    int tag;
+    DynExtRef *extref = get_extref(ctx, *(JSValue *)obj);
 
-    if (dynamic_is_extref(ctx, obj) == DYNTYPE_FALSE) {
+    if (!extref) {
         return -DYNTYPE_TYPEERR;
     }
 
-    tag_v = dynamic_get_property(ctx, obj, "@tag");
-    ref_v = dynamic_get_property(ctx, obj, "@ref");
-    *pres = (void *)(uintptr_t)JS_VALUE_GET_INT(*ref_v);
-
-    tag = JS_VALUE_GET_INT(*tag_v);
-
-    js_free(ctx->js_ctx, tag_v);
-    js_free(ctx->js_ctx, ref_v);
-
-    return tag;
+    *pres = extref->ref;
+    return extref->tag;
 }
 
 bool
@@ -921,6 +1091,7 @@ dynamic_set_prototype(dyn_ctx_t ctx, dyn_value_t obj,
         && JS_VALUE_GET_TAG(*proto_obj_ptr) != JS_TAG_OBJECT) {
         return -DYNTYPE_TYPEERR;
     }
+    dynamic_invalidate_instanceof_cache(ctx, NULL);
     int res = JS_SetPrototype(ctx->js_ctx, *obj_ptr, *proto_obj_ptr);
     return res == 1 ? DYNTYPE_SUCCESS : -DYNTYPE_EXCEPTION;
 }
@@ -969,7 +1140,7 @@ dynamic_instanceof(dyn_ctx_t ctx, const dyn_value_t src_obj,
     JSValue *src = (JSValue *)src_obj;
     JSValue *dst = (JSValue *)dst_obj;
 
-    int ret = JS_OrdinaryIsInstanceOf1(ctx->js_ctx, *src, *dst);
+    int ret = dynamic_lookup_instanceof(ctx, *src, *dst);
     if (ret == -1) {
         return -DYNTYPE_EXCEPTION;
     }
@@ -1086,19 +1257,17 @@ dynamic_throw_exception(dyn_ctx_t ctx, dyn_value_t obj)
 int
 dynamic_get_array_length(dyn_ctx_t ctx, dyn_value_t obj)
 {
-    dyn_value_t length_value = NULL;
-    int length = 0;
-
-    length_value = dynamic_get_property(ctx, obj, "length");
-    if (!JS_IsNumber(*(JSValue *)length_value)) {
-        return -DYNTYPE_TYPEERR;
-    }
-    length = JS_VALUE_GET_TAG(*(JSValue *)length_value) == JS_TAG_INT
-                 ? JS_VALUE_GET_INT(*(JSValue *)length_value)
+    JSValue *obj_ptr = (JSValue *)obj;
+    JSValue length_value;
+    int length;
+
+    /* read the length with the atom cached in the context, no atom or box is
+     * created, for arrays the length is the first property of the shape */
+    length_value = JS_GetProperty(ctx->js_ctx, *obj_ptr, ctx->length_atom);
+    length = JS_VALUE_GET_TAG(length_value) == JS_TAG_INT
+                 ? JS_VALUE_GET_INT(length_value)
                  : -DYNTYPE_TYPEERR;
-    if (length_value) {
-        js_free(ctx->js_ctx, length_value);
-    }
+    JS_FreeValue(ctx->js_ctx, length_value);
 
     return length;
 }
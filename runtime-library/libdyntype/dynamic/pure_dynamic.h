@@ -49,6 +49,19 @@ dynamic_release(dyn_ctx_t ctx, dyn_value_t obj);
 void
 dynamic_collect(dyn_ctx_t ctx);
 
+/* temporary values are freed together when the scope they are created in
+ * ends, they must not be released one by one */
+uint32_t
+dynamic_temp_scope_begin(dyn_ctx_t ctx);
+
+void
+dynamic_temp_scope_end(dyn_ctx_t ctx, uint32_t scope);
+
+/* move a value created by the other APIs to the current temporary scope,
+ * returns NULL and keeps the value unchanged if failed */
+dyn_value_t
+dynamic_move_to_temp(dyn_ctx_t ctx, dyn_value_t obj);
+
 /********************************************/
 /*     APIs exposed to wasm application     */
 /********************************************/
@@ -97,6 +110,10 @@ dynamic_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem);
 dyn_value_t
 dynamic_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index);
 
+/* get an element of an array as a temporary value */
+dyn_value_t
+dynamic_get_elem_temp(dyn_ctx_t ctx, dyn_value_t obj, int index);
+
 int
 dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
                      dyn_value_t value);
@@ -137,8 +154,19 @@ dynamic_to_string(dyn_ctx_t ctx, dyn_value_t obj);
 
 int
 dynamic_to_cstring(dyn_ctx_t ctx, dyn_value_t str_obj, char **pres);
+int
+dynamic_to_cstring_len(dyn_ctx_t ctx, dyn_value_t str_obj, char **pres,
+                       uint32_t *plen);
+/* UTF-8 length of a string read from its QuickJS storage, buf is filled if
+ * it's not NULL. Returns false if str_obj is not a string */
+bool
+dynamic_encode_string_utf8(dyn_ctx_t ctx, dyn_value_t str_obj, char *buf,
+                           uint32_t *plen);
 void
 dynamic_free_cstring(dyn_ctx_t ctx, char *str);
+/* identity of the string storage, NULL if obj isn't a string */
+const void *
+dynamic_get_string_id(dyn_ctx_t ctx, dyn_value_t obj);
 
 bool
 dynamic_is_undefined(dyn_ctx_t ctx, dyn_value_t obj);
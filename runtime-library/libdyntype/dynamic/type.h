@@ -8,6 +8,68 @@
 #include "quickjs.h"
 #include <string.h>
 
+/* Layout of JSString in quickjs.c (built without DUMP_LEAKS), it is used to
+ * read the string storage without converting the string */
+typedef struct QJSString {
+    int ref_count;
+    uint32_t len : 31;
+    uint8_t is_wide_char : 1;
+    uint32_t hash : 30;
+    uint8_t atom_type : 2;
+    uint32_t hash_next;
+    union {
+        uint8_t str8[0];
+        uint16_t str16[0];
+    } u;
+} QJSString;
+
+/* JS_STRING_LEN_MAX in quickjs.c */
+#define QJS_STRING_LEN_MAX ((1 << 30) - 1)
+
+#define DYN_GLOBAL_CACHE_SIZE 32
+
+/* The atom of a global variable name, keyed by the address of the name, which
+ * is a constant string of the wasm module in most cases. The name is copied
+ * to check a hit, since the address may be reused by another name. The value
+ * is read from the global object on every lookup, so a global reassigned by
+ * JS code is never stale. */
+typedef struct DynGlobalCacheEntry {
+    const char *name_addr;
+    char *name;
+    JSAtom atom;
+} DynGlobalCacheEntry;
+
+#define DYN_STRING_CONST_CACHE_SIZE 64
+
+/* A string created by string.const, keyed by the address of the constant in
+ * the wasm module, so a constant evaluated again is not decoded again. The
+ * constant is copied to check a hit, like the names of the global cache. */
+typedef struct DynStringConstCacheEntry {
+    const char *addr;
+    char *bytes;
+    JSValue str;
+} DynStringConstCacheEntry;
+
+#define DYN_INSTANCEOF_CACHE_SIZE 16
+
+/* A result of instanceof, keyed by the prototype of the checked object and
+ * the constructor. Both are referenced, so their addresses are not reused by
+ * other objects while the entry is alive. */
+typedef struct DynInstanceOfCacheEntry {
+    JSValue proto;
+    JSValue ctor;
+    bool result;
+} DynInstanceOfCacheEntry;
+
+/* The last position of a WTF-8 stringview, so the byte offsets of sequential
+ * accesses are mapped to code units without walking the string again. The
+ * string is referenced, so its address is not reused by another string. */
+typedef struct DynWTF8Cursor {
+    JSValue str;
+    uint32_t byte_pos;
+    uint32_t unit_pos;
+} DynWTF8Cursor;
+
 typedef struct DynTypeContext {
     JSRuntime *js_rt;
     JSContext *js_ctx;
@@ -15,4 +77,37 @@ typedef struct DynTypeContext {
     JSValue *js_null;
     JSClassID extref_class_id;
     JSValue *extref_class;
+    JSAtom extref_atom;
+    JSAtom length_atom;
+    JSValue global_obj;
+    DynGlobalCacheEntry global_cache[DYN_GLOBAL_CACHE_SIZE];
+    DynInstanceOfCacheEntry instanceof_cache[DYN_INSTANCEOF_CACHE_SIZE];
+    /* chunks of the temporary values, see dynamic_new_temp_value */
+    JSValue **temp_chunks;
+    uint32_t temp_chunk_count;
+    uint32_t temp_top;
+    DynWTF8Cursor wtf8_cursor;
+    DynStringConstCacheEntry string_const_cache[DYN_STRING_CONST_CACHE_SIZE];
 } DynTypeContext;
+
+#define DYN_TEMP_CHUNK_SIZE 64
+
+/* Opaque data of extref class objects */
+typedef struct DynExtRef {
+    void *ref;
+    external_ref_tag tag;
+} DynExtRef;
+
+/* get a global variable through the global cache, implemented in context.c */
+JSValue
+dynamic_lookup_global(dyn_ctx_t ctx, const char *name);
+
+/* check obj instanceof ctor through the instanceof cache, returns -1 if an
+ * exception is thrown, implemented in context.c */
+int
+dynamic_lookup_instanceof(dyn_ctx_t ctx, JSValue obj, JSValue ctor);
+
+/* drop the cached results when a "prototype" property is written, prop is
+ * NULL if the prototype of an object is replaced */
+void
+dynamic_invalidate_instanceof_cache(dyn_ctx_t ctx, const char *prop);
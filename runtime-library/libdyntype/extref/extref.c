@@ -9,21 +9,18 @@
 #include "bh_assert.h"
 #include "bh_common.h"
 #include "gc_export.h"
-#include "wamr_utils.h"
 #include "type_utils.h"
 #include "object_utils.h"
 
 #define EXTREF_PROLOGUE()                                                    \
     int ext_tag;                                                             \
-    void *p_table_index;                                                     \
-    uint32_t table_index;                                                    \
+    void *ref;                                                               \
     wasm_exec_env_t exec_env = dyntype_context_get_exec_env();               \
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env); \
                                                                              \
     bh_assert(exec_env);                                                     \
                                                                              \
-    ext_tag = dynamic_to_extref(ctx, obj, &p_table_index);                   \
-    table_index = (uint32_t)(uintptr_t)p_table_index;
+    ext_tag = dynamic_to_extref(ctx, obj, &ref);
 
 int
 extref_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
@@ -35,7 +32,7 @@ extref_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
         WasmArrayInfo arr_info;
         wasm_value_t unboxed_elem_value = { 0 };
 
-        get_static_array_info(exec_env, table_index, &arr_info);
+        get_static_array_info(exec_env, (wasm_obj_t)ref, &arr_info);
 
         /* unbox value from any */
         unbox_value_from_any(exec_env, ctx, elem, arr_info.element_type,
@@ -63,7 +60,7 @@ extref_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
         wasm_value_t elem_value = { 0 };
         dyn_value_t elem_res_any = NULL;
 
-        get_static_array_info(exec_env, table_index, &arr_info);
+        get_static_array_info(exec_env, (wasm_obj_t)ref, &arr_info);
 
         /* get value from array */
         wasm_array_obj_get_elem(arr_info.ref, index, false, &elem_value);
@@ -89,8 +86,7 @@ extref_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
     if (ext_tag == ExtObj) {
         int index;
         wasm_ref_type_t field_type;
-        wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+        wasm_obj_t wasm_obj = (wasm_obj_t)ref;
         wasm_value_t wasm_value = { .gc_obj = wasm_obj };
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
@@ -122,8 +118,7 @@ extref_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     if (ext_tag == ExtObj) {
         int index;
         wasm_ref_type_t field_type;
-        wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+        wasm_obj_t wasm_obj = (wasm_obj_t)ref;
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
         index =
@@ -145,7 +140,7 @@ extref_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
             return NULL;
         }
 
-        get_static_array_info(exec_env, table_index, &arr_info);
+        get_static_array_info(exec_env, (wasm_obj_t)ref, &arr_info);
         return dynamic_new_number(ctx, (double)arr_info.lengh);
     }
 
@@ -166,8 +161,7 @@ extref_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     if (ext_tag == ExtObj) {
         int index;
         wasm_ref_type_t field_type;
-        wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+        wasm_obj_t wasm_obj = (wasm_obj_t)ref;
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
         index =
@@ -196,8 +190,7 @@ extref_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     if (ext_tag == ExtObj) {
         int index;
         wasm_ref_type_t field_type;
-        wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+        wasm_obj_t wasm_obj = (wasm_obj_t)ref;
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
         index =
@@ -228,20 +221,40 @@ extref_invoke(dyn_ctx_t ctx, const char *name, dyn_value_t obj, int argc,
 
     if (ext_tag == ExtObj) {
         /* invoke method of static typed object */
+        int index, flag;
+        wasm_ref_type_t field_type;
+        wasm_obj_t wasm_obj = (wasm_obj_t)ref;
+
         bh_assert(name);
+        bh_assert(wasm_obj_is_struct_obj(wasm_obj));
 
+        index = get_prop_flag_and_index_of_struct(exec_env, name, &wasm_obj,
+                                                  &field_type, &flag);
+        if (index >= 0 && flag == METHOD) {
+            /* fast path: call the vtable entry directly, so no closure and
+             * extref are created for the method */
+            wasm_value_t vtable = { 0 }, method = { 0 };
+
+            wasm_struct_obj_get_field((wasm_struct_obj_t)wasm_obj, 0, false,
+                                      &vtable);
+            wasm_struct_obj_get_field((wasm_struct_obj_t)vtable.gc_obj, index,
+                                      false, &method);
+            return call_wasm_method_with_boxing(
+                exec_env, ctx, (wasm_func_obj_t)method.gc_obj, wasm_obj, argc,
+                args);
+        }
+
+        /* fields holding a closure */
         field_any_obj = dyntype_get_property(ctx, obj, name);
         /* the method property has been boxed to newExtref, need to unbox to
          * get the real ptr */
         bh_assert(dyntype_is_extref(ctx, field_any_obj));
-        ext_tag = dynamic_to_extref(ctx, field_any_obj, (void **)&p_table_index);
-        table_index = (uint32_t)(uintptr_t)p_table_index;
+        ext_tag = dynamic_to_extref(ctx, field_any_obj, &ref);
     }
 
     if (ext_tag == ExtFunc) {
         /* invoke static closure */
-        wasm_obj_t func_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+        wasm_obj_t func_obj = (wasm_obj_t)ref;
         bh_assert(wasm_obj_is_struct_obj(func_obj));
         res = call_wasm_func_with_boxing(
             exec_env, ctx, (wasm_anyref_obj_t)func_obj, argc, args);
@@ -260,61 +273,98 @@ extref_invoke(dyn_ctx_t ctx, const char *name, dyn_value_t obj, int argc,
     return res;
 }
 
+/* Key arrays of static objects cached per meta. Class meta is immutable, so
+ * the keys of a given meta never change. The cached arrays are only handed out
+ * to dyntype_get_keys which copies them, so they never escape to user code.
+ * Entries are keyed by module instance and meta offset like the meta name
+ * indexes, since the native address of a meta may be reused by another
+ * instance, and they are dropped when their instance is destroyed */
+#define KEYS_CACHE_BUCKETS 64
+
+typedef struct ExtRefKeysCacheEntry {
+    struct ExtRefKeysCacheEntry *next;
+    wasm_module_inst_t module_inst;
+    uint32_t meta_offset;
+    dyn_value_t keys;
+} ExtRefKeysCacheEntry;
+
+static ExtRefKeysCacheEntry *keys_cache[KEYS_CACHE_BUCKETS];
+
+static dyn_value_t
+create_keys_of_meta(wasm_exec_env_t exec_env, dyn_ctx_t ctx, void *meta_addr)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    dyn_value_t arr = NULL, str = NULL;
+    uint32_t prop_count = 0, i = 0;
+    char *prop_name = NULL;
+
+    prop_count = get_meta_fields_count(meta_addr);
+    arr = dynamic_new_array(ctx, prop_count);
+    if (!arr) {
+        wasm_runtime_set_exception(module_inst, "alloc memory failed");
+        return NULL;
+    }
+
+    for (i = 0; i < prop_count; i++) {
+        prop_name = (char *)get_field_name_from_meta_index(exec_env, meta_addr,
+                                                           FIELD, i);
+        if (!prop_name) {
+            wasm_runtime_set_exception(module_inst,
+                                       "property name get from meta is null");
+            dyntype_release(ctx, arr);
+            return NULL;
+        }
+#if WASM_ENABLE_STRINGREF != 0
+        wasm_stringref_obj_t sringref_obj =
+            create_wasm_string(exec_env, prop_name);
+        str =
+            dynamic_new_string(ctx, wasm_stringref_obj_get_value(sringref_obj));
+#else
+        str = dynamic_new_string(ctx, prop_name, strlen(prop_name));
+#endif
+        dynamic_set_elem(ctx, arr, i, str);
+        dyntype_release(ctx, str);
+    }
+
+    return arr;
+}
+
 dyn_value_t
 extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
 {
-    dyn_value_t arr = NULL, str = NULL;
+    dyn_value_t arr = NULL;
     void *meta_addr = NULL;
-    uint32_t prop_count = 0, i = 0, iter_prop_count = 0;
-    char *prop_name = NULL;
-    char **prop_name_list = NULL;
+    uint32_t meta_offset, bucket;
+    ExtRefKeysCacheEntry *entry;
     EXTREF_PROLOGUE()
 
     if (ext_tag == ExtObj) {
-        wasm_obj_t obj_struct =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+        wasm_obj_t obj_struct = (wasm_obj_t)ref;
         /* get meta, get prop names */
         meta_addr = get_meta_of_object(exec_env, obj_struct);
-        prop_count = get_meta_fields_count(meta_addr);
-        if (prop_count > 0) {
-            prop_name_list = wasm_runtime_malloc(prop_count * sizeof(char *));
-            if (!prop_name_list) {
-                wasm_runtime_set_exception(module_inst, "alloc memory failed");
-                return NULL;
-            }
-        }
-        for (i = 0; i < prop_count; i++) {
-            prop_name = (char *)get_field_name_from_meta_index(
-                exec_env, meta_addr, FIELD, i);
-            if (prop_name) {
-                *(prop_name_list + iter_prop_count) = prop_name;
-                iter_prop_count++;
-            }
-            else {
-                wasm_runtime_set_exception(
-                    module_inst, "property name get from meta is null");
-                return NULL;
+
+        meta_offset = wasm_runtime_addr_native_to_app(module_inst, meta_addr);
+        bucket = (meta_offset >> 2) % KEYS_CACHE_BUCKETS;
+        for (entry = keys_cache[bucket]; entry; entry = entry->next) {
+            if (entry->meta_offset == meta_offset
+                && entry->module_inst == module_inst) {
+                return dynamic_hold(ctx, entry->keys);
             }
         }
-        /* set prop names into an array */
-        if (iter_prop_count > 0) {
-            arr = dynamic_new_array(ctx, iter_prop_count);
-            for (i = 0; i < iter_prop_count; i++) {
-#if WASM_ENABLE_STRINGREF != 0
-                wasm_stringref_obj_t sringref_obj =
-                    create_wasm_string(exec_env, prop_name_list[i]);
-                str = dynamic_new_string(
-                    ctx, wasm_stringref_obj_get_value(sringref_obj));
-#else
-                str = dynamic_new_string(ctx, prop_name_list[i],
-                                         strlen(prop_name_list[i]));
-#endif
-                dynamic_set_elem(ctx, arr, i, str);
-                dyntype_release(ctx, str);
-            }
+
+        arr = create_keys_of_meta(exec_env, ctx, meta_addr);
+        if (!arr) {
+            return NULL;
         }
-        if (prop_name_list) {
-            wasm_runtime_free(prop_name_list);
+
+        entry = wasm_runtime_malloc(sizeof(ExtRefKeysCacheEntry));
+        if (entry) {
+            entry->module_inst = module_inst;
+            entry->meta_offset = meta_offset;
+            entry->keys = arr;
+            entry->next = keys_cache[bucket];
+            keys_cache[bucket] = entry;
+            return dynamic_hold(ctx, arr);
         }
     }
     else {
@@ -325,6 +375,44 @@ extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
     return arr;
 }
 
+/* release the cached key arrays of module_inst, or of all the instances if
+ * module_inst is NULL */
+static void
+release_keys_cache(dyn_ctx_t ctx, wasm_module_inst_t module_inst)
+{
+    ExtRefKeysCacheEntry *entry, **p_entry;
+    uint32_t i;
+
+    for (i = 0; i < KEYS_CACHE_BUCKETS; i++) {
+        p_entry = &keys_cache[i];
+        while ((entry = *p_entry)) {
+            if (module_inst && entry->module_inst != module_inst) {
+                p_entry = &entry->next;
+                continue;
+            }
+            *p_entry = entry->next;
+            dyntype_release(ctx, entry->keys);
+            wasm_runtime_free(entry);
+        }
+    }
+}
+
+void
+destroy_extref_keys_cache(void *module_inst)
+{
+    dyn_ctx_t ctx = dyntype_get_context();
+
+    if (ctx && module_inst) {
+        release_keys_cache(ctx, (wasm_module_inst_t)module_inst);
+    }
+}
+
+void
+extref_context_destroy(dyn_ctx_t ctx)
+{
+    release_keys_cache(ctx, NULL);
+}
+
 void
 extref_unsupported(const char *reason)
 {
@@ -37,6 +37,16 @@ extref_invoke(dyn_ctx_t ctx, const char *name, dyn_value_t obj, int argc,
 dyn_value_t
 extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj);
 
+/* release the key arrays cached for a module instance, called when the
+ * instance is destroyed */
+void
+destroy_extref_keys_cache(void *module_inst);
+
+/* release the resources cached by extref, must be called before the dynamic
+ * context is destroyed */
+void
+extref_context_destroy(dyn_ctx_t ctx);
+
 void
 extref_unsupported(const char *reason);
 
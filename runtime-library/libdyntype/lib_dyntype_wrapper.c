@@ -7,7 +7,6 @@
 #include "libdyntype_export.h"
 #include "object_utils.h"
 #include "type_utils.h"
-#include "wamr_utils.h"
 
 /****************** Context access *****************/
 void *
@@ -101,10 +100,10 @@ dyntype_add_elem_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
 
 wasm_anyref_obj_t
 dyntype_new_extref_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
-                           void *ptr, external_ref_tag tag)
+                           wasm_obj_t obj, external_ref_tag tag)
 {
     RETURN_BOX_ANYREF(
-        dyntype_new_extref(UNBOX_ANYREF(ctx), ptr, tag, (void *)exec_env),
+        box_obj_to_extref(exec_env, UNBOX_ANYREF(ctx), obj, tag),
         UNBOX_ANYREF(ctx));
 }
 
@@ -134,6 +133,13 @@ dyntype_get_elem_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
         UNBOX_ANYREF(ctx));
 }
 
+int
+dyntype_get_array_length_wrapper(wasm_exec_env_t exec_env,
+                                 wasm_anyref_obj_t ctx, wasm_anyref_obj_t obj)
+{
+    return dyntype_get_array_length(UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj));
+}
+
 int
 dyntype_has_property_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
                              wasm_anyref_obj_t obj, const char *prop)
@@ -269,24 +275,16 @@ void *
 dyntype_to_string_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
                           wasm_anyref_obj_t obj)
 {
-    char *value = NULL;
-    int ret;
-    void *new_string_struct = NULL;
+    void *new_string_struct =
+        unbox_string_from_any(exec_env, UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj));
 
-    ret = dyntype_to_cstring(UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj), &value);
-    if (ret != DYNTYPE_SUCCESS) {
-        if (value) {
-            dyntype_free_cstring(UNBOX_ANYREF(ctx), value);
-        }
+    if (!new_string_struct
+        && !wasm_runtime_get_exception(wasm_runtime_get_module_inst(exec_env))) {
         wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
                                    "libdyntype: failed to convert to cstring");
-        return NULL;
     }
 
-    new_string_struct = create_wasm_string(exec_env, value);
-    dyntype_free_cstring(UNBOX_ANYREF(ctx), value);
-
-    return (void *)new_string_struct;
+    return new_string_struct;
 }
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
 
@@ -346,8 +344,7 @@ dyntype_toString_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
     char *str;
     dyn_type_t type;
     void *res = NULL;
-    void *table_elem;
-    int32_t table_index;
+    void *ref;
     dyn_value_t dyn_ctx, dyn_value;
     char *tmp_value = NULL;
 
@@ -363,18 +360,20 @@ dyntype_toString_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
             }
             res = create_wasm_string(exec_env, tmp_value);
         } else {
-            dyntype_to_extref(dyn_ctx, dyn_value, &table_elem);
-            table_index = (int32_t)(intptr_t)table_elem;
-            table_elem = wamr_utils_get_table_element(exec_env, table_index);
-            res = array_to_string(exec_env, dyn_ctx, table_elem, NULL);
+            dyntype_to_extref(dyn_ctx, dyn_value, &ref);
+            res = array_to_string(exec_env, dyn_ctx, ref, NULL);
         }
     } else {
+#if WASM_ENABLE_STRINGREF != 0
         dyntype_to_cstring(dyn_ctx, dyn_value, &str);
         if (str == NULL) {
             return NULL;
         }
         res = create_wasm_string(exec_env, str);
         dyntype_free_cstring(dyn_ctx, str);
+#else
+        res = unbox_string_from_any(exec_env, dyn_ctx, dyn_value);
+#endif
     }
 
     return res;
@@ -449,7 +448,6 @@ dyntype_cmp_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
     dyn_type_t type_l, type_r;
     bool l_is_null = false, r_is_null = false;
     void *lhs_ref, *rhs_ref;
-    int32_t lhs_idx, rhs_idx;
 
     type_l = dyntype_typeof(UNBOX_ANYREF(ctx), UNBOX_ANYREF(lhs));
     type_r = dyntype_typeof(UNBOX_ANYREF(ctx), UNBOX_ANYREF(rhs));
@@ -487,15 +485,11 @@ dyntype_cmp_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
 
     if (!l_is_null) {
         dyntype_to_extref(UNBOX_ANYREF(ctx), UNBOX_ANYREF(lhs), &lhs_ref);
-        lhs_idx = (int32_t)(intptr_t)lhs_ref;
-        lhs_ref = wamr_utils_get_table_element(exec_env, lhs_idx);
     } else {
         lhs_ref = NULL;
     }
     if (!r_is_null) {
         dyntype_to_extref(UNBOX_ANYREF(ctx), UNBOX_ANYREF(rhs), &rhs_ref);
-        rhs_idx = (int32_t)(intptr_t)rhs_ref;
-        rhs_ref = wamr_utils_get_table_element(exec_env, rhs_idx);
     } else {
         rhs_ref = NULL;
     }
@@ -542,36 +536,35 @@ dyntype_instanceof_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
                            const wasm_anyref_obj_t src_obj,
                            const wasm_anyref_obj_t dst_obj)
 {
-    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
-    wasm_module_t module = wasm_runtime_get_module(module_inst);
-    dyn_type_t obj_type;
-    dyn_ctx_t dyn_ctx;
-    dyn_value_t dyn_src;
-    void *table_elem;
-    int32_t table_idx;
+    wasm_module_inst_t module_inst;
+    wasm_module_t module;
+    void *ref;
     wasm_obj_t obj;
     wasm_obj_t inst_obj;
     wasm_defined_type_t inst_type;
 
-    dyn_ctx = UNBOX_ANYREF(ctx);
-    dyn_src = UNBOX_ANYREF(src_obj);
-    obj_type = dyntype_typeof(dyn_ctx, dyn_src);
-
     // if src is not an extref object, return false
-    if (obj_type < DynExtRefObj) {
+    if (dyntype_to_extref(UNBOX_ANYREF(ctx), UNBOX_ANYREF(src_obj), &ref)
+        < 0) {
         return 0;
     }
-    dyntype_to_extref(dyn_ctx, dyn_src, &table_elem);
-    table_idx = (int32_t)(intptr_t)table_elem;
-    table_elem = wamr_utils_get_table_element(exec_env, table_idx);
 
-    obj = (wasm_obj_t)table_elem;
+    obj = (wasm_obj_t)ref;
     inst_obj = (wasm_obj_t)dst_obj;
     if (!wasm_obj_is_struct_obj(inst_obj)) {
         return 0;
     }
     inst_type = wasm_obj_get_defined_type(inst_obj);
 
+    /* the right side is a default instance of the class, compare its static
+     * type directly before walking the super types */
+    if (wasm_obj_is_struct_obj(obj)
+        && wasm_obj_get_defined_type(obj) == inst_type) {
+        return 1;
+    }
+
+    module_inst = wasm_runtime_get_module_inst(exec_env);
+    module = wasm_runtime_get_module(module_inst);
     return wasm_obj_is_instance_of_defined_type(obj, inst_type, module);
 }
 
@@ -600,17 +593,16 @@ dyntype_get_global_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
                       UNBOX_ANYREF(ctx));
 }
 
-wasm_anyref_obj_t
-dyntype_new_object_with_class_wrapper(wasm_exec_env_t exec_env,
-                                      wasm_anyref_obj_t ctx, const char *name,
-                                      wasm_anyref_obj_t args_array)
+/* the args are only used during the call, they are got as temporary values
+ * instead of heap allocated boxes */
+#define DYN_ARGS_STACK_COUNT 16
+
+static dyn_value_t *
+get_args_from_array(wasm_exec_env_t exec_env, dyn_ctx_t dyn_ctx,
+                    dyn_value_t dyn_args, dyn_value_t *args_buf, int *p_argc)
 {
-    dyn_value_t ret = NULL;
-    dyn_value_t dyn_args = UNBOX_ANYREF(args_array);
-    dyn_value_t dyn_ctx = UNBOX_ANYREF(ctx);
-    dyn_value_t *argv = NULL;
-    int argc = 0;
-    int i = 0;
+    dyn_value_t *args = args_buf;
+    int argc, i;
 
     argc = dyntype_get_array_length(dyn_ctx, dyn_args);
     if (argc < 0) {
@@ -618,9 +610,9 @@ dyntype_new_object_with_class_wrapper(wasm_exec_env_t exec_env,
                                    "array length is less than 0");
         return NULL;
     }
-    if (argc) {
-        argv = wasm_runtime_malloc(sizeof(dyn_value_t) * argc);
-        if (!argv) {
+    if (argc > DYN_ARGS_STACK_COUNT) {
+        args = wasm_runtime_malloc(sizeof(dyn_value_t) * argc);
+        if (!args) {
             wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
                                        "alloc memory failed");
             return NULL;
@@ -628,22 +620,45 @@ dyntype_new_object_with_class_wrapper(wasm_exec_env_t exec_env,
     }
 
     for (i = 0; i < argc; i++) {
-        argv[i] = dyntype_get_elem(dyn_ctx, dyn_args, i);
+        args[i] = dyntype_get_elem_temp(dyn_ctx, dyn_args, i);
+    }
+
+    *p_argc = argc;
+    return args;
+}
+
+wasm_anyref_obj_t
+dyntype_new_object_with_class_wrapper(wasm_exec_env_t exec_env,
+                                      wasm_anyref_obj_t ctx, const char *name,
+                                      wasm_anyref_obj_t args_array)
+{
+    dyn_value_t ret = NULL;
+    dyn_value_t dyn_args = UNBOX_ANYREF(args_array);
+    dyn_value_t dyn_ctx = UNBOX_ANYREF(ctx);
+    dyn_value_t argv_buf[DYN_ARGS_STACK_COUNT];
+    dyn_value_t *argv = NULL;
+    int argc = 0;
+    uint32_t temp_scope;
+
+    temp_scope = dyntype_temp_scope_begin(dyn_ctx);
+    argv = get_args_from_array(exec_env, dyn_ctx, dyn_args, argv_buf, &argc);
+    if (!argv) {
+        dyntype_temp_scope_end(dyn_ctx, temp_scope);
+        return NULL;
     }
 
     ret = dyntype_new_object_with_class(dyn_ctx, name, argc, argv);
 
+    dyntype_temp_scope_end(dyn_ctx, temp_scope);
+    if (argv != argv_buf) {
+        wasm_runtime_free(argv);
+    }
+
     if (!ret) {
         wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
                                    "dyntype_new_object_with_class failed");
         return NULL;
     }
-    if (argv) {
-        for (i = 0; i < argc; i++) {
-            dyntype_release(dyn_ctx, argv[i]);
-        }
-        wasm_runtime_free(argv);
-    }
 
     RETURN_BOX_ANYREF(ret, dyn_ctx);
 }
@@ -654,40 +669,28 @@ dyntype_invoke_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
                        const char *name, wasm_anyref_obj_t obj,
                        wasm_anyref_obj_t args_array)
 {
-    int i = 0;
-    uint32_t argc = 0;
+    int argc = 0;
     dyn_value_t dyn_ctx = UNBOX_ANYREF(ctx);
     dyn_value_t dyn_obj = UNBOX_ANYREF(obj);
     dyn_value_t dyn_args = UNBOX_ANYREF(args_array);
+    dyn_value_t func_args_buf[DYN_ARGS_STACK_COUNT];
     dyn_value_t *func_args = NULL;
     dyn_value_t func_ret = NULL;
+    uint32_t temp_scope;
 
-    argc = dyntype_get_array_length(dyn_ctx, dyn_args);
-    if (argc < 0) {
-        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
-                                   "array length is less than 0");
+    temp_scope = dyntype_temp_scope_begin(dyn_ctx);
+    func_args =
+        get_args_from_array(exec_env, dyn_ctx, dyn_args, func_args_buf, &argc);
+    if (!func_args) {
+        dyntype_temp_scope_end(dyn_ctx, temp_scope);
         return NULL;
     }
-    if (argc > 0) {
-        func_args = wasm_runtime_malloc(sizeof(dyn_value_t) * argc);
-        if (!func_args) {
-            wasm_runtime_set_exception(
-                wasm_runtime_get_module_inst(exec_env),
-                "alloc memory failed");
-            return NULL;
-        }
-    }
-
-    for (i = 0; i < argc; i++) {
-        func_args[i] = dyntype_get_elem(dyn_ctx, dyn_args, i);
-    }
 
     func_ret = dyntype_invoke(dyn_ctx, name, dyn_obj, argc, func_args);
 
-    if (func_args) {
-        for (i = 0; i < argc; i++) {
-            dyntype_release(dyn_ctx, func_args[i]);
-        }
+    /* only the result is returned to wasm */
+    dyntype_temp_scope_end(dyn_ctx, temp_scope);
+    if (func_args != func_args_buf) {
         wasm_runtime_free(func_args);
     }
 
@@ -700,14 +703,10 @@ dyntype_callback_wasm_dispatcher(void *exec_env_v, dyn_ctx_t ctx, void *vfunc,
                                  dyn_value_t *args)
 {
     wasm_exec_env_t exec_env = exec_env_v;
-    uint32_t func_id = (uint32_t)(uintptr_t)vfunc;
-    void *closure = NULL;
     void *res = NULL;
 
-    closure = wamr_utils_get_table_element(exec_env, func_id);
-    res = call_wasm_func_with_boxing(exec_env, ctx,
-                                     (wasm_anyref_obj_t)closure, argc,
-                                     args);
+    res = call_wasm_func_with_boxing(exec_env, ctx, (wasm_anyref_obj_t)vfunc,
+                                     argc, args);
 
     if (!res) {
         res = dyntype_new_undefined(ctx);
@@ -733,7 +732,8 @@ static NativeSymbol native_symbols[] = {
     REG_NATIVE_FUNC(dyntype_add_elem, "(rrr)"),
     REG_NATIVE_FUNC(dyntype_set_elem, "(rrir)"),
     REG_NATIVE_FUNC(dyntype_get_elem, "(rri)r"),
-    REG_NATIVE_FUNC(dyntype_new_extref, "(rii)r"),
+    REG_NATIVE_FUNC(dyntype_get_array_length, "(rr)i"),
+    REG_NATIVE_FUNC(dyntype_new_extref, "(rri)r"),
     REG_NATIVE_FUNC(dyntype_new_object_with_proto, "(rr)r"),
 
     REG_NATIVE_FUNC(dyntype_set_prototype, "(rrr)i"),
@@ -760,7 +760,7 @@ static NativeSymbol native_symbols[] = {
     REG_NATIVE_FUNC(dyntype_to_bool, "(rr)i"),
     REG_NATIVE_FUNC(dyntype_to_number, "(rr)F"),
     REG_NATIVE_FUNC(dyntype_to_string, "(rr)r"),
-    REG_NATIVE_FUNC(dyntype_to_extref, "(rr)i"),
+    REG_NATIVE_FUNC(dyntype_to_extref, "(rr)r"),
     REG_NATIVE_FUNC(dyntype_is_falsy, "(rr)i"),
 
     REG_NATIVE_FUNC(dyntype_typeof, "(rr)r"),
@@ -10,6 +10,7 @@
 
 static void *g_exec_env = NULL;
 static dyntype_callback_dispatcher_t g_cb_dispatcher = NULL;
+static dyntype_extref_finalizer_t g_extref_finalizer = NULL;
 
 /********************************************/
 /*     APIs exposed to runtime embedder     */
@@ -31,6 +32,8 @@ dyntype_context_destroy(dyn_ctx_t ctx)
 {
     g_exec_env = NULL;
     g_cb_dispatcher = NULL;
+    g_extref_finalizer = NULL;
+    extref_context_destroy(ctx);
     dynamic_context_destroy(ctx);
 }
 
@@ -58,6 +61,18 @@ dyntype_get_callback_dispatcher()
     return g_cb_dispatcher;
 }
 
+void
+dyntype_set_extref_finalizer(dyntype_extref_finalizer_t finalizer)
+{
+    g_extref_finalizer = finalizer;
+}
+
+dyntype_extref_finalizer_t
+dyntype_get_extref_finalizer()
+{
+    return g_extref_finalizer;
+}
+
 int
 dyntype_execute_pending_jobs(dyn_ctx_t ctx)
 {
@@ -213,6 +228,37 @@ dyntype_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
     MIXED_TYPE_DISPATCH(get_elem, obj, index)
 }
 
+uint32_t
+dyntype_temp_scope_begin(dyn_ctx_t ctx)
+{
+    return dynamic_temp_scope_begin(ctx);
+}
+
+void
+dyntype_temp_scope_end(dyn_ctx_t ctx, uint32_t scope)
+{
+    dynamic_temp_scope_end(ctx, scope);
+}
+
+dyn_value_t
+dyntype_get_elem_temp(dyn_ctx_t ctx, dyn_value_t obj, int index)
+{
+    dyn_value_t elem, res;
+
+    if (dyntype_is_extref(ctx, obj)) {
+        /* boxing a wasm element always creates a new value */
+        elem = extref_get_elem(ctx, obj, index);
+        if (!elem) {
+            return NULL;
+        }
+        if (!(res = dynamic_move_to_temp(ctx, elem))) {
+            dynamic_release(ctx, elem);
+        }
+        return res;
+    }
+    return dynamic_get_elem_temp(ctx, obj, index);
+}
+
 int
 dyntype_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
                      dyn_value_t value)
@@ -259,6 +305,7 @@ dyn_value_t dyntype_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
     dyn_value_t extref_arr = NULL, dynamic_arr = NULL, total_arr = NULL,
                 tmp_elem = NULL;
     uint32_t extref_arr_len = 0, dynamic_arr_len = 0, total_arr_len = 0, i = 0;
+    uint32_t temp_scope;
 
     is_extref = dyntype_is_extref(ctx, obj);
     if (is_extref) {
@@ -270,16 +317,17 @@ dyn_value_t dyntype_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
 
     total_arr_len = extref_arr_len + dynamic_arr_len;
     total_arr = dyntype_new_array(ctx, total_arr_len);
+    /* the key arrays are dynamic arrays, their elements are only copied */
+    temp_scope = dynamic_temp_scope_begin(ctx);
     for (i = 0; i < extref_arr_len; i++) {
-        tmp_elem = dyntype_get_elem(ctx, extref_arr, i);
+        tmp_elem = dynamic_get_elem_temp(ctx, extref_arr, i);
         dyntype_set_elem(ctx, total_arr, i, tmp_elem);
-        dyntype_release(ctx, tmp_elem);
     }
     for (i = 0; i < dynamic_arr_len; i++) {
-        tmp_elem = dyntype_get_elem(ctx, dynamic_arr, i);
+        tmp_elem = dynamic_get_elem_temp(ctx, dynamic_arr, i);
         dyntype_set_elem(ctx, total_arr, i + extref_arr_len, tmp_elem);
-        dyntype_release(ctx, tmp_elem);
     }
+    dynamic_temp_scope_end(ctx, temp_scope);
 
     if (extref_arr) {
         dyntype_release(ctx, extref_arr);
@@ -452,5 +500,5 @@ dyntype_get_global(dyn_ctx_t ctx, const char *name)
 int
 dyntype_get_array_length(dyn_ctx_t ctx, dyn_value_t obj)
 {
-    return dynamic_get_array_length(ctx, obj);
+    MIXED_TYPE_DISPATCH(get_array_length, obj)
 }
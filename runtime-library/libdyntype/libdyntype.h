@@ -33,6 +33,8 @@ typedef dyn_value_t (*dyntype_callback_dispatcher_t)(void *env, dyn_ctx_t ctx,
                                                      int argc,
                                                      dyn_value_t *args);
 
+typedef void (*dyntype_extref_finalizer_t)(void *env, void *ref);
+
 typedef enum external_ref_tag {
     ExtObj,
     ExtFunc,
@@ -186,6 +188,9 @@ dyntype_new_array(dyn_ctx_t ctx, int len);
 /**
  * @brief Boxing an external reference to a dynamic value
  *
+ * @note The pointer is held directly by the boxed value, the embedder is
+ * responsible for keeping it alive until the extref finalizer is called
+ *
  * @param ctx the dynamic type system context
  * @param ptr opaque pointer to external reference
  * @param tag external reference tag
@@ -217,6 +222,40 @@ dyntype_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem);
 dyn_value_t
 dyntype_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index);
 
+/******************* Temporary values *******************/
+
+/**
+ * @brief Open a scope for temporary values, which are allocated from an
+ * arena instead of the heap, and are freed together when the scope ends
+ *
+ * @param ctx the dynamic type system context
+ * @return the scope, should be passed to dyntype_temp_scope_end
+ */
+uint32_t
+dyntype_temp_scope_begin(dyn_ctx_t ctx);
+
+/**
+ * @brief Free all the temporary values created after the scope began, scopes
+ * must be ended in the reverse order they are opened
+ *
+ * @param ctx the dynamic type system context
+ * @param scope the scope returned by dyntype_temp_scope_begin
+ */
+void
+dyntype_temp_scope_end(dyn_ctx_t ctx, uint32_t scope);
+
+/**
+ * @brief Get an element of an array as a temporary value, it must not be
+ * released by dyntype_release, or be kept after the scope ends
+ *
+ * @param ctx the dynamic type system context
+ * @param obj the array
+ * @param index the index of the element
+ * @return temporary value if success, NULL otherwise
+ */
+dyn_value_t
+dyntype_get_elem_temp(dyn_ctx_t ctx, dyn_value_t obj, int index);
+
 /**
  * @brief Set the property of a dynamic object
  *
@@ -90,6 +90,27 @@ dyntype_set_callback_dispatcher(dyntype_callback_dispatcher_t callback);
 dyntype_callback_dispatcher_t
 dyntype_get_callback_dispatcher();
 
+/**
+ * @brief Set the finalizer for external references. It is called with the
+ * bound execution environment and the referenced pointer when the boxed
+ * extref is collected by libdyntype, so the implementer can release the root
+ * it held on the pointer.
+ *
+ * @note If another finalizer is set, the previous one will be overwrite.
+ *
+ * @param finalizer the finalizer to set
+ */
+void
+dyntype_set_extref_finalizer(dyntype_extref_finalizer_t finalizer);
+
+/**
+ * @brief Get the finalizer for external references.
+ *
+ * @return the finalizer for external references
+ */
+dyntype_extref_finalizer_t
+dyntype_get_extref_finalizer();
+
 /******************* event loop *******************/
 
 /**
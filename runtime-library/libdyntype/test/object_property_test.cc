@@ -705,3 +705,111 @@ TEST_F(ObjectPropertyTest, get_keys)
     dyntype_release(ctx, obj);
     dyntype_release(ctx, length_property);
 }
+
+TEST_F(ObjectPropertyTest, temporary_values)
+{
+    dyn_value_t arr = dyntype_new_array(ctx, 0);
+    dyn_value_t temps[200];
+    uint32_t outer_scope, inner_scope;
+    double num;
+    int i;
+
+    for (i = 0; i < 200; i++) {
+        dyn_value_t elem = dyntype_new_number(ctx, i);
+        dyntype_set_elem(ctx, arr, i, elem);
+        dyntype_release(ctx, elem);
+    }
+
+    outer_scope = dyntype_temp_scope_begin(ctx);
+    for (i = 0; i < 100; i++) {
+        temps[i] = dyntype_get_elem_temp(ctx, arr, i);
+    }
+
+    /* values of an inner scope don't overwrite the outer ones */
+    inner_scope = dyntype_temp_scope_begin(ctx);
+    for (i = 100; i < 200; i++) {
+        temps[i] = dyntype_get_elem_temp(ctx, arr, i);
+    }
+    for (i = 0; i < 200; i++) {
+        EXPECT_TRUE(temps[i] != NULL);
+        dyntype_to_number(ctx, temps[i], &num);
+        EXPECT_EQ(num, (double)i);
+    }
+    dyntype_temp_scope_end(ctx, inner_scope);
+
+    for (i = 0; i < 100; i++) {
+        dyntype_to_number(ctx, temps[i], &num);
+        EXPECT_EQ(num, (double)i);
+    }
+    dyntype_temp_scope_end(ctx, outer_scope);
+
+    dyntype_release(ctx, arr);
+}
+
+TEST_F(ObjectPropertyTest, get_array_length)
+{
+    dyn_value_t arr = dyntype_new_array(ctx, 3);
+    dyn_value_t obj = dyntype_new_object(ctx);
+    dyn_value_t num = dyntype_new_number(ctx, 1);
+
+    EXPECT_EQ(dyntype_get_array_length(ctx, arr), 3);
+    dyntype_set_elem(ctx, arr, 9, num);
+    EXPECT_EQ(dyntype_get_array_length(ctx, arr), 10);
+
+    EXPECT_EQ(dyntype_get_array_length(ctx, obj), -DYNTYPE_TYPEERR);
+    EXPECT_EQ(dyntype_get_array_length(ctx, num), -DYNTYPE_TYPEERR);
+
+    dyntype_release(ctx, arr);
+    dyntype_release(ctx, obj);
+    dyntype_release(ctx, num);
+}
+
+TEST_F(ObjectPropertyTest, cached_global_lookup)
+{
+    const char *map_name = "Map";
+    dyn_value_t global_obj = dyntype_get_global(ctx, "globalThis");
+    dyn_value_t map_ctor1 = dyntype_get_global(ctx, map_name);
+    dyn_value_t map_ctor2 = dyntype_get_global(ctx, map_name);
+    dyn_value_t map_obj, replaced, num, object_ctor, src, argv[2];
+    double value;
+
+    EXPECT_TRUE(dyntype_is_function(ctx, map_ctor1));
+    EXPECT_TRUE(
+        dyntype_cmp(ctx, map_ctor1, map_ctor2, EqualsEqualsEqualsToken));
+
+    map_obj = dyntype_new_object_with_class(ctx, map_name, 0, NULL);
+    EXPECT_TRUE(dyntype_instanceof(ctx, map_obj, map_ctor1));
+    dyntype_release(ctx, map_obj);
+
+    /* a global reassigned through libdyntype is seen by the next lookup */
+    num = dyntype_new_number(ctx, 42);
+    dyntype_set_property(ctx, global_obj, map_name, num);
+    replaced = dyntype_get_global(ctx, map_name);
+    EXPECT_TRUE(dyntype_is_number(ctx, replaced));
+    dyntype_to_number(ctx, replaced, &value);
+    EXPECT_EQ(value, 42.0);
+    dyntype_release(ctx, num);
+    dyntype_release(ctx, replaced);
+
+    /* and so is a global reassigned by JS code, Object.assign(globalThis,
+     * { Map: 7 }) doesn't go through libdyntype */
+    object_ctor = dyntype_get_global(ctx, "Object");
+    src = dyntype_new_object(ctx);
+    num = dyntype_new_number(ctx, 7);
+    dyntype_set_property(ctx, src, map_name, num);
+    argv[0] = global_obj;
+    argv[1] = src;
+    dyntype_release(ctx, dyntype_invoke(ctx, "assign", object_ctor, 2, argv));
+    replaced = dyntype_get_global(ctx, map_name);
+    EXPECT_TRUE(dyntype_is_number(ctx, replaced));
+    dyntype_to_number(ctx, replaced, &value);
+    EXPECT_EQ(value, 7.0);
+
+    dyntype_release(ctx, num);
+    dyntype_release(ctx, src);
+    dyntype_release(ctx, object_ctor);
+    dyntype_release(ctx, replaced);
+    dyntype_release(ctx, map_ctor1);
+    dyntype_release(ctx, map_ctor2);
+    dyntype_release(ctx, global_obj);
+}
@@ -77,3 +77,33 @@ TEST_F(PrototypeTest, prototype)
     wasm_string_destroy(wasm_string);
 #endif
 }
+
+TEST_F(PrototypeTest, instanceof_cache)
+{
+    dyn_value_t obj = dyntype_new_object(ctx);
+    dyn_value_t date_ctor = dyntype_get_global(ctx, "Date");
+    dyn_value_t object_ctor = dyntype_get_global(ctx, "Object");
+    EXPECT_NE(date_ctor, nullptr);
+    EXPECT_NE(object_ctor, nullptr);
+
+    /* the second lookup hits the cache */
+    EXPECT_FALSE(dyntype_instanceof(ctx, obj, date_ctor));
+    EXPECT_FALSE(dyntype_instanceof(ctx, obj, date_ctor));
+    EXPECT_TRUE(dyntype_instanceof(ctx, obj, object_ctor));
+
+    /* replacing the prototype invalidates the cached results */
+    dyn_value_t date_proto = dyntype_get_property(ctx, date_ctor, "prototype");
+    EXPECT_EQ(dyntype_set_prototype(ctx, obj, date_proto), DYNTYPE_SUCCESS);
+    EXPECT_TRUE(dyntype_instanceof(ctx, obj, date_ctor));
+    EXPECT_TRUE(dyntype_instanceof(ctx, obj, object_ctor));
+
+    EXPECT_EQ(dyntype_set_prototype(ctx, obj, dyntype_new_null(ctx)),
+              DYNTYPE_SUCCESS);
+    EXPECT_FALSE(dyntype_instanceof(ctx, obj, date_ctor));
+    EXPECT_FALSE(dyntype_instanceof(ctx, obj, object_ctor));
+
+    dyntype_release(ctx, date_proto);
+    dyntype_release(ctx, object_ctor);
+    dyntype_release(ctx, date_ctor);
+    dyntype_release(ctx, obj);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+
+/* module used by the ts_call tests:
+ *
+ * (type $context (struct))
+ * (type $closure_func
+ *   (func (param (ref null $context) (ref null $context) f64 f64)
+ *         (result f64)))
+ * (type $closure (struct (field (mut (ref null $context)))
+ *                        (field (mut (ref null $context)))
+ *                        (field (mut (ref null $closure_func)))))
+ * (func (export "add") (param f64 f64) (result f64)
+ *   (f64.add (local.get 0) (local.get 1)))
+ * (func (export "not") (param i32) (result i32)
+ *   (i32.eqz (local.get 0)))
+ * (func (export "echo") (param stringref) (result stringref)
+ *   (local.get 0))
+ * (func $mul (type $closure_func)
+ *   (f64.mul (local.get 2) (local.get 3)))
+ * (func (export "makeClosure") (result (ref null $closure))
+ *   (struct.new $closure (ref.null $context) (ref.null $context)
+ *                        (ref.func $mul)))
+ * (func (export "isNull") (param anyref) (result i32)
+ *   (ref.is_null (local.get 0)))
+ * (elem declare func $mul)
+ */
+unsigned char ts_call_app[] = {
+  0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00, 0x01, 0x32, 0x08, 0x5F,
+  0x00, 0x60, 0x04, 0x6C, 0x00, 0x6C, 0x00, 0x7C, 0x7C, 0x01, 0x7C, 0x5F,
+  0x03, 0x6C, 0x00, 0x01, 0x6C, 0x00, 0x01, 0x6C, 0x01, 0x01, 0x60, 0x02,
+  0x7C, 0x7C, 0x01, 0x7C, 0x60, 0x01, 0x7F, 0x01, 0x7F, 0x60, 0x01, 0x64,
+  0x01, 0x64, 0x60, 0x00, 0x01, 0x6C, 0x02, 0x60, 0x01, 0x6E, 0x01, 0x7F,
+  0x03, 0x07, 0x06, 0x03, 0x04, 0x05, 0x01, 0x06, 0x07, 0x07, 0x2B, 0x05,
+  0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x03, 0x6E, 0x6F, 0x74, 0x00, 0x01,
+  0x04, 0x65, 0x63, 0x68, 0x6F, 0x00, 0x02, 0x0B, 0x6D, 0x61, 0x6B, 0x65,
+  0x43, 0x6C, 0x6F, 0x73, 0x75, 0x72, 0x65, 0x00, 0x04, 0x06, 0x69, 0x73,
+  0x4E, 0x75, 0x6C, 0x6C, 0x00, 0x05, 0x09, 0x05, 0x01, 0x03, 0x00, 0x01,
+  0x03, 0x0A, 0x2E, 0x06, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0xA0, 0x0B,
+  0x05, 0x00, 0x20, 0x00, 0x45, 0x0B, 0x04, 0x00, 0x20, 0x00, 0x0B, 0x07,
+  0x00, 0x20, 0x02, 0x20, 0x03, 0xA2, 0x0B, 0x0B, 0x00, 0xD0, 0x00, 0xD0,
+  0x00, 0xD2, 0x03, 0xFB, 0x07, 0x02, 0x0B, 0x05, 0x00, 0x20, 0x00, 0xD1,
+  0x0B
+};
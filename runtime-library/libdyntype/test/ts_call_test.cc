@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "libdyntype_export.h"
+#include "ts_call_app.h"
+#include "wasm_export.h"
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "object_utils.h"
+#include "type_utils.h"
+}
+
+class TSCallTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        ctx = dyntype_context_init();
+
+        wasm_runtime_init();
+        wasm_module = wasm_runtime_load(ts_call_app, sizeof(ts_call_app),
+                                        error_buf, sizeof(error_buf));
+        ASSERT_TRUE(wasm_module != NULL) << error_buf;
+        module_inst = wasm_runtime_instantiate(wasm_module, 8192, 1024,
+                                               error_buf, sizeof(error_buf));
+        ASSERT_TRUE(module_inst != NULL) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 4096);
+        ASSERT_TRUE(exec_env != NULL);
+
+        dyntype_context_set_exec_env(exec_env);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env) {
+            wasm_runtime_destroy_exec_env(exec_env);
+        }
+        if (module_inst) {
+            wasm_runtime_deinstantiate(module_inst);
+        }
+        destroy_ts_type_kind_tables();
+        if (wasm_module) {
+            wasm_runtime_unload(wasm_module);
+        }
+        wasm_runtime_destroy();
+        dyntype_context_destroy(ctx);
+    }
+
+    dyn_ctx_t ctx;
+    char error_buf[128];
+    wasm_module_t wasm_module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+};
+
+static ts_value_t
+number_value(double num)
+{
+    ts_value_t value;
+
+    value.type = TS_NUMBER;
+    value.of.f64 = num;
+    return value;
+}
+
+TEST_F(TSCallTest, call_exported_function)
+{
+    ts_call_handle_t *handle = ts_call_handle_new(exec_env, "add");
+    ts_value_t args[2] = { number_value(1.5), number_value(2) };
+    ts_value_t result;
+
+    ASSERT_TRUE(handle != NULL);
+    EXPECT_EQ(ts_call_handle_get_param_count(handle), 2u);
+
+    EXPECT_TRUE(ts_call(exec_env, handle, 2, args, &result));
+    EXPECT_EQ(result.type, TS_NUMBER);
+    EXPECT_EQ(result.of.f64, 3.5);
+
+    /* ints are converted to the f64 slot */
+    args[1].type = TS_INT;
+    args[1].of.i32 = 10;
+    EXPECT_TRUE(ts_call(exec_env, handle, 2, args, &result));
+    EXPECT_EQ(result.of.f64, 11.5);
+
+    /* the handle is reused without resolving the signature again */
+    for (int i = 0; i < 100; i++) {
+        args[0] = number_value(i);
+        EXPECT_TRUE(ts_call(exec_env, handle, 2, args, &result));
+        EXPECT_EQ(result.of.f64, i + 10);
+    }
+
+    ts_call_handle_free(exec_env, handle);
+
+    EXPECT_TRUE(ts_call_handle_new(exec_env, "not_exist") == NULL);
+    wasm_runtime_clear_exception(module_inst);
+}
+
+TEST_F(TSCallTest, boolean_result)
+{
+    ts_call_handle_t *handle = ts_call_handle_new(exec_env, "not");
+    ts_value_t arg, result;
+
+    ASSERT_TRUE(handle != NULL);
+
+    arg.type = TS_BOOLEAN;
+    arg.of.i32 = 0;
+    EXPECT_TRUE(ts_call(exec_env, handle, 1, &arg, &result));
+    EXPECT_EQ(result.type, TS_BOOLEAN);
+    EXPECT_EQ(result.of.i32, 1);
+
+    arg.of.i32 = 1;
+    EXPECT_TRUE(ts_call(exec_env, handle, 1, &arg, &result));
+    EXPECT_EQ(result.of.i32, 0);
+
+    ts_call_handle_free(exec_env, handle);
+}
+
+TEST_F(TSCallTest, string_param_and_result)
+{
+    ts_call_handle_t *handle = ts_call_handle_new(exec_env, "echo");
+    ts_value_t str, result;
+
+    ASSERT_TRUE(handle != NULL);
+    ASSERT_TRUE(ts_value_new_string(exec_env, "hello", 5, &str));
+    EXPECT_EQ(str.type, TS_STRING);
+
+    EXPECT_TRUE(ts_call(exec_env, handle, 1, &str, &result));
+    EXPECT_EQ(result.type, TS_STRING);
+    EXPECT_EQ(result.of.ref, str.of.ref);
+
+    /* the result is held across the calls below */
+    EXPECT_TRUE(ts_value_hold(exec_env, &result));
+    ts_value_release(exec_env, &str);
+
+    str.type = TS_NULL;
+    str.of.ref = NULL;
+    EXPECT_TRUE(ts_call(exec_env, handle, 1, &str, &str));
+    EXPECT_EQ(str.type, TS_NULL);
+
+    ts_value_release(exec_env, &result);
+    ts_call_handle_free(exec_env, handle);
+}
+
+TEST_F(TSCallTest, call_closure)
+{
+    ts_call_handle_t *make_handle = ts_call_handle_new(exec_env, "makeClosure");
+    ts_call_handle_t *handle;
+    ts_value_t closure, args[2] = { number_value(3), number_value(4) };
+    ts_value_t result;
+
+    ASSERT_TRUE(make_handle != NULL);
+    EXPECT_EQ(ts_call_handle_get_param_count(make_handle), 0u);
+    ASSERT_TRUE(ts_call(exec_env, make_handle, 0, NULL, &closure));
+    EXPECT_EQ(closure.type, TS_FUNCTION);
+    ts_call_handle_free(exec_env, make_handle);
+
+    /* context and thiz are passed by the handle, not by the caller */
+    handle = ts_call_handle_from_closure(exec_env, (wasm_obj_t)closure.of.ref);
+    ASSERT_TRUE(handle != NULL);
+    EXPECT_EQ(ts_call_handle_get_param_count(handle), 2u);
+
+    EXPECT_TRUE(ts_call(exec_env, handle, 2, args, &result));
+    EXPECT_EQ(result.type, TS_NUMBER);
+    EXPECT_EQ(result.of.f64, 12);
+
+    ts_call_handle_free(exec_env, handle);
+}
+
+TEST_F(TSCallTest, any_param)
+{
+    ts_call_handle_t *handle = ts_call_handle_new(exec_env, "isNull");
+    dyn_value_t num = dyntype_new_number(ctx, 1);
+    ts_value_t arg, result;
+
+    ASSERT_TRUE(handle != NULL);
+
+    /* the boxed value is released by the finalizer of the anyref */
+    arg.type = TS_ANY;
+    arg.of.ref = box_ptr_to_anyref(exec_env, ctx, num);
+    EXPECT_TRUE(ts_call(exec_env, handle, 1, &arg, &result));
+    EXPECT_EQ(result.of.i32, 0);
+
+    arg.type = TS_NULL;
+    arg.of.ref = NULL;
+    EXPECT_TRUE(ts_call(exec_env, handle, 1, &arg, &result));
+    EXPECT_EQ(result.of.i32, 1);
+
+    ts_call_handle_free(exec_env, handle);
+}
+
+TEST_F(TSCallTest, reject_mismatched_args)
+{
+    ts_call_handle_t *add_handle = ts_call_handle_new(exec_env, "add");
+    ts_call_handle_t *echo_handle = ts_call_handle_new(exec_env, "echo");
+    ts_call_handle_t *any_handle = ts_call_handle_new(exec_env, "isNull");
+    ts_value_t args[2] = { number_value(1), number_value(2) };
+    ts_value_t str, result;
+
+    ASSERT_TRUE(add_handle != NULL);
+    ASSERT_TRUE(echo_handle != NULL);
+    ASSERT_TRUE(any_handle != NULL);
+    ASSERT_TRUE(ts_value_new_string(exec_env, "a", 1, &str));
+
+    /* wrong param count */
+    EXPECT_FALSE(ts_call(exec_env, add_handle, 1, args, &result));
+    EXPECT_TRUE(wasm_runtime_get_exception(module_inst) != NULL);
+    wasm_runtime_clear_exception(module_inst);
+
+    /* a reference passed to a number param */
+    args[1] = str;
+    EXPECT_FALSE(ts_call(exec_env, add_handle, 2, args, &result));
+    EXPECT_TRUE(wasm_runtime_get_exception(module_inst) != NULL);
+    wasm_runtime_clear_exception(module_inst);
+
+    /* a number passed to a reference param */
+    EXPECT_FALSE(ts_call(exec_env, echo_handle, 1, args, &result));
+    EXPECT_TRUE(wasm_runtime_get_exception(module_inst) != NULL);
+    wasm_runtime_clear_exception(module_inst);
+
+    EXPECT_FALSE(ts_call(exec_env, any_handle, 1, args, &result));
+    wasm_runtime_clear_exception(module_inst);
+
+    /* a static typed reference passed to an any param */
+    EXPECT_FALSE(ts_call(exec_env, any_handle, 1, &str, &result));
+    wasm_runtime_clear_exception(module_inst);
+
+    ts_value_release(exec_env, &str);
+    ts_call_handle_free(exec_env, add_handle);
+    ts_call_handle_free(exec_env, echo_handle);
+    ts_call_handle_free(exec_env, any_handle);
+}
@@ -7,6 +7,10 @@
 #include "string_object.h"
 #include <gtest/gtest.h>
 
+#if WASM_ENABLE_STRINGREF != 0
+#include "stringref_qjs.h"
+#endif
+
 class TypesTest : public testing::Test
 {
   protected:
@@ -257,7 +261,7 @@ TEST_F(TypesTest, create_string)
         char *raw_value = nullptr;
 #if WASM_ENABLE_STRINGREF != 0
         WASMString wasm_string =
-            wasm_string_new_with_encoding((void *)str_values[i], i, WTF16);
+            wasm_string_new_with_encoding((void *)str_values[i], i, WTF8);
         dyn_value_t str = dyntype_new_string(ctx, wasm_string);
 #else
         dyn_value_t str = dyntype_new_string(ctx, str_values[i], i);
@@ -307,6 +311,332 @@ TEST_F(TypesTest, create_string)
     }
 }
 
+#if WASM_ENABLE_STRINGREF != 0
+TEST_F(TypesTest, measure_string)
+{
+    /* 8-bit storage with non-ASCII characters */
+    WASMString latin1 = wasm_string_new_const("h\xc3\xa9llo w\xc3\xb6rld");
+    EXPECT_EQ(wasm_string_measure(latin1, WTF16), 11);
+    EXPECT_EQ(wasm_string_measure(latin1, UTF8), 13);
+    /* the second measure is read from the cache */
+    EXPECT_EQ(wasm_string_measure(latin1, WTF8), 13);
+
+    WASMString wide = wasm_string_new_const("字符串");
+    EXPECT_EQ(wasm_string_measure(wide, WTF16), 3);
+    EXPECT_EQ(wasm_string_measure(wide, UTF8), 9);
+
+    WASMString pair = wasm_string_new_const("\xf0\x9f\x98\x80");
+    EXPECT_EQ(wasm_string_measure(pair, WTF16), 2);
+    EXPECT_EQ(wasm_string_measure(pair, UTF8), 4);
+
+    wasm_string_destroy(pair);
+    wasm_string_destroy(wide);
+    wasm_string_destroy(latin1);
+}
+
+TEST_F(TypesTest, encode_string_range)
+{
+    const char *raw_str = "ab\xc3\xa9\xf0\x9f\x98\x80cd";
+    WASMString str = wasm_string_new_const(raw_str);
+    int32 len = wasm_string_measure(str, WTF16);
+    char buffer[32];
+    uint32 pos = 0, next_pos = 0;
+    int32 size = 0, n;
+
+    /* stringview_wtf8 encodes in chunks of four bytes, a chunk ends at the
+     * last code point boundary in it */
+    while (pos < strlen(raw_str)) {
+        n = wasm_string_encode(str, pos, 4, buffer + size, &next_pos, UTF8);
+        ASSERT_GT(n, 0);
+        EXPECT_EQ(next_pos, pos + n);
+        size += n;
+        pos = next_pos;
+    }
+    EXPECT_EQ(size, (int32)strlen(raw_str));
+    EXPECT_EQ(memcmp(buffer, raw_str, size), 0);
+
+    /* a chunk shorter than the code point at pos encodes nothing */
+    EXPECT_EQ(wasm_string_encode(str, 4, 2, buffer, &next_pos, UTF8), 0);
+    EXPECT_EQ(next_pos, 4u);
+
+    /* without next_pos, pos and count are in code units, measure only */
+    EXPECT_EQ(wasm_string_encode(str, 0, len, NULL, NULL, UTF8),
+              (int32)strlen(raw_str));
+    EXPECT_EQ(wasm_string_encode(str, 2, 1, NULL, NULL, UTF8), 2);
+    /* the surrogate pair is not split */
+    EXPECT_EQ(wasm_string_encode(str, 3, 1, NULL, NULL, UTF8), 4);
+
+    uint16 units[2];
+    EXPECT_EQ(wasm_string_encode(str, 0, 2, units, NULL, WTF16), 2);
+    EXPECT_EQ(units[0], 'a');
+    EXPECT_EQ(units[1], 'b');
+
+    wasm_string_destroy(str);
+}
+
+TEST_F(TypesTest, string_views)
+{
+    /* a, e with acute, grinning face (a surrogate pair), b */
+    WASMString str = wasm_string_new_const("a\xc3\xa9\xf0\x9f\x98\x80" "b");
+    uint32 expected[] = { 'a', 0xE9, 0x1F600, 'b' };
+    uint32 pos = 0, consumed, cp;
+    int i = 0;
+
+    while ((cp = wasm_string_next_codepoint(str, pos)) != (uint32)-1) {
+        EXPECT_EQ(cp, expected[i++]);
+        pos = wasm_string_advance(str, pos, 1, &consumed);
+        EXPECT_EQ(consumed, 1u);
+    }
+    EXPECT_EQ(i, 4);
+    EXPECT_EQ(pos, 5u);
+
+    EXPECT_EQ(wasm_string_rewind(str, pos, 2, &consumed), 2u);
+    EXPECT_EQ(consumed, 2u);
+
+    EXPECT_EQ(wasm_string_get_wtf16_codeunit(str, 1), (int16)0xE9);
+    EXPECT_EQ(wasm_string_get_wtf16_codeunit(str, 5), -1);
+
+    /* WTF-8 positions are byte offsets rounded down to a code point */
+    EXPECT_EQ(wasm_string_advance(str, 0, 2, NULL), 1);
+    EXPECT_EQ(wasm_string_advance(str, 1, 4, NULL), 3);
+    EXPECT_EQ(wasm_string_advance(str, 3, 4, NULL), 7);
+
+    WASMString slice = wasm_string_slice(str, 3, 7, STRING_VIEW_WTF8);
+    WASMString face = wasm_string_new_const("\xf0\x9f\x98\x80");
+    EXPECT_EQ(wasm_string_eq(slice, face), 1);
+
+    wasm_string_destroy(face);
+    wasm_string_destroy(slice);
+    wasm_string_destroy(str);
+}
+
+TEST_F(TypesTest, concat_rope_string)
+{
+    const char *raw_piece = "0123456789";
+    std::string expected;
+    WASMString piece = wasm_string_new_const(raw_piece);
+    WASMString str = wasm_string_new_const("");
+
+    /* long enough to create ropes and to flatten them by the depth bound */
+    for (int i = 0; i < 1000; i++) {
+        WASMString res = wasm_string_concat(str, piece);
+        wasm_string_destroy(str);
+        str = res;
+        expected += raw_piece;
+    }
+    EXPECT_EQ(wasm_string_measure(str, WTF16), (int32)expected.size());
+
+    WASMString flat = wasm_string_new_const(expected.c_str());
+    EXPECT_EQ(wasm_string_eq(str, flat), 1);
+
+    dyn_value_t boxed = dyntype_new_string(ctx, str);
+    char *raw_value = nullptr;
+    EXPECT_EQ(dyntype_to_cstring(ctx, boxed, &raw_value), DYNTYPE_SUCCESS);
+    EXPECT_STREQ(raw_value, expected.c_str());
+    dyntype_free_cstring(ctx, raw_value);
+    dyntype_release(ctx, boxed);
+
+    /* a rope as the operand of another rope */
+    WASMString twice = wasm_string_concat(str, str);
+    EXPECT_EQ(wasm_string_measure(twice, WTF16), (int32)expected.size() * 2);
+    EXPECT_EQ(wasm_string_eq(twice, str), 0);
+
+    wasm_string_destroy(twice);
+    wasm_string_destroy(flat);
+    wasm_string_destroy(piece);
+    wasm_string_destroy(str);
+}
+
+TEST_F(TypesTest, new_string_with_encoding)
+{
+    /* h, e with acute, grinning face (a surrogate pair), ! */
+    uint16 wide_units[] = { 'h', 0xE9, 0xD83D, 0xDE00, '!' };
+    uint16 narrow_units[] = { 'h', 0xE9, '!' };
+    char ascii[] = "plain ascii";
+
+    WASMString wide = wasm_string_new_with_encoding(wide_units, 5, WTF16);
+    WASMString wide_expected =
+        wasm_string_new_const("h\xc3\xa9\xf0\x9f\x98\x80!");
+    EXPECT_EQ(wasm_string_measure(wide, WTF16), 5);
+    EXPECT_EQ(wasm_string_eq(wide, wide_expected), 1);
+
+    WASMString narrow = wasm_string_new_with_encoding(narrow_units, 3, WTF16);
+    WASMString narrow_expected = wasm_string_new_const("h\xc3\xa9!");
+    EXPECT_EQ(wasm_string_eq(narrow, narrow_expected), 1);
+
+    /* count doesn't include the null character */
+    WASMString str = wasm_string_new_with_encoding(ascii, 5, UTF8);
+    WASMString expected = wasm_string_new_const("plain");
+    EXPECT_EQ(wasm_string_eq(str, expected), 1);
+
+    wasm_string_destroy(expected);
+    wasm_string_destroy(str);
+    wasm_string_destroy(narrow_expected);
+    wasm_string_destroy(narrow);
+    wasm_string_destroy(wide_expected);
+    wasm_string_destroy(wide);
+}
+
+TEST_F(TypesTest, string_const_cache)
+{
+    char raw[] = "constant";
+    WASMString str1 = wasm_string_new_const(raw);
+    WASMString str2 = wasm_string_new_const(raw);
+    EXPECT_EQ(str1, str2);
+    EXPECT_EQ(wasm_string_eq(str1, str2), 1);
+
+    /* another constant at the same address */
+    raw[0] = 'C';
+    WASMString str3 = wasm_string_new_const(raw);
+    EXPECT_NE(str3, str1);
+    EXPECT_EQ(wasm_string_eq(str3, str1), 0);
+    EXPECT_EQ(wasm_string_get_wtf16_codeunit(str3, 0), (int16)'C');
+
+    wasm_string_destroy(str3);
+    wasm_string_destroy(str2);
+    wasm_string_destroy(str1);
+}
+
+TEST_F(TypesTest, string_search)
+{
+    std::string raw;
+    for (int i = 0; i < 40; i++) {
+        raw += "key=value;";
+    }
+    raw += "needle;key=value";
+    WASMString str = wasm_string_new_const(raw.c_str());
+    WASMString needle = wasm_string_new_const("needle");
+    WASMString sep = wasm_string_new_const(";");
+    WASMString missing = wasm_string_new_const("needles");
+    WASMString empty = wasm_string_new_const("");
+    WASMString wide = wasm_string_new_const("字符串");
+
+    EXPECT_EQ(wasm_string_index_of(str, needle, 0), 400);
+    EXPECT_EQ(wasm_string_index_of(str, needle, 401), -1);
+    EXPECT_EQ(wasm_string_index_of(str, missing, 0), -1);
+    EXPECT_EQ(wasm_string_index_of(str, sep, 10), 19);
+    EXPECT_EQ(wasm_string_index_of(str, empty, 7), 7);
+    EXPECT_EQ(wasm_string_index_of(str, wide, 0), -1);
+
+    EXPECT_EQ(wasm_string_last_index_of(str, sep, UINT32_MAX), 406);
+    EXPECT_EQ(wasm_string_last_index_of(str, sep, 405), 399);
+    EXPECT_EQ(wasm_string_last_index_of(str, empty, UINT32_MAX),
+              (int32)raw.size());
+
+    /* a needle of 8-bit characters in a wide string */
+    WASMString mixed = wasm_string_new_const("字符串 needle 字符串");
+    EXPECT_EQ(wasm_string_index_of(mixed, needle, 0), 4);
+    EXPECT_EQ(wasm_string_last_index_of(mixed, wide, UINT32_MAX), 11);
+
+    wasm_string_destroy(mixed);
+    wasm_string_destroy(wide);
+    wasm_string_destroy(empty);
+    wasm_string_destroy(missing);
+    wasm_string_destroy(sep);
+    wasm_string_destroy(needle);
+    wasm_string_destroy(str);
+}
+
+TEST_F(TypesTest, string_case_and_trim)
+{
+    WASMString str = wasm_string_new_const("Hello World, MIXED case 123");
+    WASMString lower = wasm_string_new_const("hello world, mixed case 123");
+    WASMString upper = wasm_string_new_const("HELLO WORLD, MIXED CASE 123");
+
+    WASMString res = wasm_string_to_lower_case(str);
+    EXPECT_EQ(wasm_string_eq(res, lower), 1);
+    wasm_string_destroy(res);
+    res = wasm_string_to_upper_case(str);
+    EXPECT_EQ(wasm_string_eq(res, upper), 1);
+    wasm_string_destroy(res);
+
+    /* nothing is changed, the string itself is returned */
+    res = wasm_string_to_lower_case(lower);
+    EXPECT_EQ(res, lower);
+    wasm_string_destroy(res);
+
+    /* Latin-1 letters, and characters converted by QuickJS */
+    WASMString latin1 = wasm_string_new_const("\xc3\x89t\xc3\xa9");
+    WASMString latin1_lower = wasm_string_new_const("\xc3\xa9t\xc3\xa9");
+    res = wasm_string_to_lower_case(latin1);
+    EXPECT_EQ(wasm_string_eq(res, latin1_lower), 1);
+    wasm_string_destroy(res);
+
+    WASMString wide = wasm_string_new_const("字符串 Straße");
+    WASMString wide_upper = wasm_string_new_const("字符串 STRASSE");
+    res = wasm_string_to_upper_case(wide);
+    EXPECT_EQ(wasm_string_eq(res, wide_upper), 1);
+    wasm_string_destroy(res);
+
+    WASMString padded = wasm_string_new_const(" \t\n hello world \r\n");
+    WASMString trimmed = wasm_string_new_const("hello world");
+    WASMString spaces = wasm_string_new_const(" \t \n");
+    res = wasm_string_trim(padded);
+    EXPECT_EQ(wasm_string_eq(res, trimmed), 1);
+    wasm_string_destroy(res);
+    res = wasm_string_trim(trimmed);
+    EXPECT_EQ(res, trimmed);
+    wasm_string_destroy(res);
+    res = wasm_string_trim(spaces);
+    EXPECT_EQ(wasm_string_measure(res, WTF16), 0);
+    wasm_string_destroy(res);
+
+    wasm_string_destroy(spaces);
+    wasm_string_destroy(trimmed);
+    wasm_string_destroy(padded);
+    wasm_string_destroy(wide_upper);
+    wasm_string_destroy(wide);
+    wasm_string_destroy(latin1_lower);
+    wasm_string_destroy(latin1);
+    wasm_string_destroy(upper);
+    wasm_string_destroy(lower);
+    wasm_string_destroy(str);
+}
+
+TEST_F(TypesTest, slice_string_view)
+{
+    std::string raw;
+    for (int i = 0; i < 10; i++) {
+        raw += "0123456789";
+    }
+    WASMString str = wasm_string_new_const(raw.c_str());
+
+    /* long enough to reference the storage of str */
+    WASMString slice = wasm_string_slice(str, 10, 90, STRING_VIEW_WTF16);
+    EXPECT_EQ(wasm_string_measure(slice, WTF16), 80);
+    EXPECT_EQ(wasm_string_measure(slice, WTF8), 80);
+    EXPECT_EQ(wasm_string_get_wtf16_codeunit(slice, 3), (int16)'3');
+
+    /* a slice of a slice, and a short slice copied at once */
+    WASMString inner = wasm_string_slice(slice, 20, 60, STRING_VIEW_WTF16);
+    WASMString expected = wasm_string_new_const(raw.substr(30, 40).c_str());
+    EXPECT_EQ(wasm_string_eq(inner, expected), 1);
+
+    WASMString digits = wasm_string_slice(inner, 0, 10, STRING_VIEW_WTF16);
+    WASMString raw_digits = wasm_string_new_const("0123456789");
+    EXPECT_EQ(wasm_string_eq(digits, raw_digits), 1);
+
+    dyn_value_t boxed = dyntype_new_string(ctx, inner);
+    char *raw_value = nullptr;
+    EXPECT_EQ(dyntype_to_cstring(ctx, boxed, &raw_value), DYNTYPE_SUCCESS);
+    EXPECT_STREQ(raw_value, raw.substr(30, 40).c_str());
+    dyntype_free_cstring(ctx, raw_value);
+    dyntype_release(ctx, boxed);
+
+    /* the whole string is not copied */
+    WASMString whole = wasm_string_slice(str, 0, 100, STRING_VIEW_WTF16);
+    EXPECT_EQ(whole, str);
+
+    wasm_string_destroy(whole);
+    wasm_string_destroy(raw_digits);
+    wasm_string_destroy(digits);
+    wasm_string_destroy(expected);
+    wasm_string_destroy(inner);
+    wasm_string_destroy(slice);
+    wasm_string_destroy(str);
+}
+#endif
+
 TEST_F(TypesTest, create_array)
 {
 
@@ -407,6 +737,44 @@ TEST_F(TypesTest, create_array)
 //     dyntype_release(ctx, extfunc);
 // }
 
+static int extref_finalized_count = 0;
+static void *extref_finalized_ref = NULL;
+
+static void
+test_extref_finalizer(void *env, void *ref)
+{
+    extref_finalized_count++;
+    extref_finalized_ref = ref;
+}
+
+TEST_F(TypesTest, extref_finalizer)
+{
+    extref_finalized_count = 0;
+    extref_finalized_ref = NULL;
+    dyntype_set_extref_finalizer(test_extref_finalizer);
+
+    dyn_value_t extobj =
+        dyntype_new_extref(ctx, (void *)(uintptr_t)1024, ExtObj, NULL);
+    dyn_value_t extfunc =
+        dyntype_new_extref(ctx, (void *)(uintptr_t)2048, ExtFunc, NULL);
+    EXPECT_TRUE(dyntype_is_extref(ctx, extobj));
+    EXPECT_TRUE(dyntype_is_extref(ctx, extfunc));
+
+    void *ref = nullptr;
+    EXPECT_EQ(dyntype_to_extref(ctx, extfunc, &ref), ExtFunc);
+    EXPECT_EQ((uintptr_t)ref, 2048);
+
+    dyntype_release(ctx, extobj);
+    EXPECT_EQ(extref_finalized_count, 1);
+    EXPECT_EQ((uintptr_t)extref_finalized_ref, 1024);
+
+    dyntype_release(ctx, extfunc);
+    EXPECT_EQ(extref_finalized_count, 2);
+    EXPECT_EQ((uintptr_t)extref_finalized_ref, 2048);
+
+    dyntype_set_extref_finalizer(NULL);
+}
+
 TEST_F(TypesTest, create_object)
 {
     dyn_value_t obj = dyntype_new_object(ctx);
@@ -24,6 +24,9 @@ get_lib_console_symbols(char **p_module_name, NativeSymbol **p_native_symbols);
 extern uint32_t
 get_lib_array_symbols(char **p_module_name, NativeSymbol **p_native_symbols);
 
+extern uint32_t
+get_lib_string_symbols(char **p_module_name, NativeSymbol **p_native_symbols);
+
 extern uint32_t
 get_lib_timer_symbols(char **p_module_name, NativeSymbol **p_native_symbols);
 
@@ -35,6 +38,27 @@ dyntype_callback_wasm_dispatcher(void *exec_env_v, dyn_ctx_t ctx, void *vfunc,
                                  dyn_value_t this_obj, int argc,
                                  dyn_value_t *args);
 
+extern void
+extref_object_finalizer(void *exec_env, void *ref);
+
+extern void
+destroy_func_call_desc_cache();
+
+extern void
+destroy_ts_type_kind_tables();
+
+extern void
+destroy_struct_ic_tables();
+
+extern void
+destroy_string_conv_cache();
+
+extern void
+destroy_meta_name_indexes();
+
+extern void
+destroy_extref_keys_cache(void *module_inst);
+
 #if BH_HAS_DLFCN
 #include <dlfcn.h>
 #endif
@@ -720,6 +744,7 @@ main(int argc, char *argv[])
     /* initialize dyntype context and set callback dispatcher */
     dyn_ctx = dyntype_context_init();
     dyntype_set_callback_dispatcher(dyntype_callback_wasm_dispatcher);
+    dyntype_set_extref_finalizer(extref_object_finalizer);
 
 #if WASM_ENABLE_LOG != 0
     bh_log_set_verbose_level(log_verbose_level);
@@ -756,6 +781,13 @@ main(int argc, char *argv[])
         goto fail1;
     }
 
+    symbol_count = get_lib_string_symbols(&module_name, &native_symbols);
+    if (!wasm_runtime_register_natives(module_name, native_symbols,
+                                       symbol_count)) {
+        printf("Register stdlib APIs failed.\n");
+        goto fail1;
+    }
+
     symbol_count = get_lib_timer_symbols(&module_name, &native_symbols);
     if (!wasm_runtime_register_natives(module_name, native_symbols,
                                        symbol_count)) {
@@ -878,10 +910,20 @@ main(int argc, char *argv[])
     execute_micro_tasks(exec_env, dyn_ctx);
 
 fail4:
+    /* release the extref keys cached for the module instance */
+    destroy_extref_keys_cache(wasm_module_inst);
+
     /* destroy the module instance */
     wasm_runtime_deinstantiate(wasm_module_inst);
 
 fail3:
+    /* release the caches referring to the types of the module */
+    destroy_func_call_desc_cache();
+    destroy_ts_type_kind_tables();
+    destroy_struct_ic_tables();
+    destroy_string_conv_cache();
+    destroy_meta_name_indexes();
+
     /* unload the module */
     wasm_runtime_unload(wasm_module);
 
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gc_export.h"
+#include "libdyntype_export.h"
+#include "string_object.h"
+#include "stringref_qjs.h"
+#include "type_utils.h"
+
+static inline WASMString
+get_string(void *str)
+{
+    return (WASMString)wasm_stringref_obj_get_value(
+        (wasm_stringref_obj_t)str);
+}
+
+double
+string_indexOf(wasm_exec_env_t exec_env, void *ctx, void *str, void *search)
+{
+    return wasm_string_index_of(get_string(str), get_string(search), 0);
+}
+
+double
+string_lastIndexOf(wasm_exec_env_t exec_env, void *ctx, void *str,
+                   void *search)
+{
+    return wasm_string_last_index_of(get_string(str), get_string(search),
+                                     UINT32_MAX);
+}
+
+/* whether the RegExp created from the pattern only matches the pattern
+ * itself */
+static bool
+is_literal_pattern(WASMString pattern)
+{
+    int32 len = wasm_string_measure(pattern, WTF16), i;
+
+    for (i = 0; i < len; i++) {
+        switch (wasm_string_get_wtf16_codeunit(pattern, i)) {
+            case '\\':
+            case '^':
+            case '$':
+            case '.':
+            case '*':
+            case '+':
+            case '?':
+            case '(':
+            case ')':
+            case '[':
+            case ']':
+            case '{':
+            case '}':
+            case '|':
+                return false;
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
+double
+string_search(wasm_exec_env_t exec_env, void *ctx, void *str, void *pattern)
+{
+    dyn_ctx_t dyn_ctx;
+    dyn_value_t str_value, pattern_value, ret;
+    double res = -1;
+
+    /* a literal pattern matches where it's found as a string */
+    if (is_literal_pattern(get_string(pattern))) {
+        return wasm_string_index_of(get_string(str), get_string(pattern), 0);
+    }
+
+    /* other patterns are searched as a RegExp by the dynamic string */
+    dyn_ctx = dyntype_get_context();
+    str_value = dyntype_new_string(dyn_ctx, get_string(str));
+    pattern_value = dyntype_new_string(dyn_ctx, get_string(pattern));
+    if (!str_value || !pattern_value) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "alloc memory failed");
+    }
+    else {
+        ret = dyntype_invoke(dyn_ctx, "search", str_value, 1, &pattern_value);
+        if (!ret || dyntype_is_exception(dyn_ctx, ret)
+            || dyntype_to_number(dyn_ctx, ret, &res) != DYNTYPE_SUCCESS) {
+            wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                       "invalid regular expression");
+        }
+        if (ret) {
+            dyntype_release(dyn_ctx, ret);
+        }
+    }
+
+    if (str_value) {
+        dyntype_release(dyn_ctx, str_value);
+    }
+    if (pattern_value) {
+        dyntype_release(dyn_ctx, pattern_value);
+    }
+    return res;
+}
+
+void *
+string_replace(wasm_exec_env_t exec_env, void *ctx, void *str, void *search,
+               void *replacement)
+{
+    WASMString string = get_string(str);
+    WASMString search_string = get_string(search);
+    WASMString head, tail, prefix, res = NULL;
+    int32 pos = wasm_string_index_of(string, search_string, 0);
+    uint32 search_len;
+    void *res_obj;
+
+    if (pos < 0) {
+        return str;
+    }
+
+    search_len = wasm_string_measure(search_string, WTF16);
+    head = wasm_string_slice(string, 0, pos, STRING_VIEW_WTF16);
+    tail = wasm_string_slice(string, pos + search_len, UINT32_MAX,
+                             STRING_VIEW_WTF16);
+
+    if (head && tail
+        && (prefix = wasm_string_concat(head, get_string(replacement)))) {
+        res = wasm_string_concat(prefix, tail);
+        wasm_string_destroy(prefix);
+    }
+    if (head) {
+        wasm_string_destroy(head);
+    }
+    if (tail) {
+        wasm_string_destroy(tail);
+    }
+
+    if (!res || !(res_obj = wasm_stringref_obj_new(exec_env, res))) {
+        if (res) {
+            wasm_string_destroy(res);
+        }
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "alloc memory failed");
+        return NULL;
+    }
+
+    return res_obj;
+}
+
+void *
+string_split(wasm_exec_env_t exec_env, void *ctx, void *str, void *sep)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    WASMString string = get_string(str);
+    WASMString sep_string = get_string(sep);
+    uint32 len = wasm_string_measure(string, WTF16);
+    uint32 sep_len = wasm_string_measure(sep_string, WTF16);
+    uint32 count = 0, pos = 0, end, i;
+    WASMString *pieces;
+    wasm_struct_obj_t res;
+    int32 match;
+
+    /* count the pieces first, so the array is allocated once */
+    if (sep_len == 0) {
+        /* an empty separator splits every code unit */
+        count = len;
+    }
+    else {
+        for (count = 1;
+             (match = wasm_string_index_of(string, sep_string, pos)) >= 0;
+             count++) {
+            pos = match + sep_len;
+        }
+    }
+
+    pieces = wasm_runtime_malloc(sizeof(WASMString) * (count ? count : 1));
+    if (!pieces) {
+        wasm_runtime_set_exception(module_inst, "alloc memory failed");
+        return NULL;
+    }
+
+    for (i = 0, pos = 0; i < count; i++, pos = end + sep_len) {
+        if (sep_len == 0) {
+            end = pos + 1;
+        }
+        else if (i + 1 < count) {
+            end = wasm_string_index_of(string, sep_string, pos);
+        }
+        else {
+            end = len;
+        }
+
+        pieces[i] = wasm_string_slice(string, pos, end, STRING_VIEW_WTF16);
+        if (!pieces[i]) {
+            while (i-- > 0) {
+                wasm_string_destroy(pieces[i]);
+            }
+            wasm_runtime_free(pieces);
+            wasm_runtime_set_exception(module_inst, "alloc memory failed");
+            return NULL;
+        }
+    }
+
+    res = create_wasm_array_with_stringref(exec_env, (void **)pieces, count);
+    wasm_runtime_free(pieces);
+
+    return res;
+}
+
+/* Wrap res as the result of a method of str, which is returned itself if res
+ * is the same string, so nothing is allocated */
+static void *
+new_string_result(wasm_exec_env_t exec_env, void *str, WASMString res)
+{
+    void *res_obj;
+
+    if (res == get_string(str)) {
+        wasm_string_destroy(res);
+        return str;
+    }
+
+    if (!res || !(res_obj = wasm_stringref_obj_new(exec_env, res))) {
+        if (res) {
+            wasm_string_destroy(res);
+        }
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "alloc memory failed");
+        return NULL;
+    }
+
+    return res_obj;
+}
+
+void *
+string_toLowerCase(wasm_exec_env_t exec_env, void *ctx, void *str)
+{
+    return new_string_result(exec_env, str,
+                             wasm_string_to_lower_case(get_string(str)));
+}
+
+void *
+string_toUpperCase(wasm_exec_env_t exec_env, void *ctx, void *str)
+{
+    return new_string_result(exec_env, str,
+                             wasm_string_to_upper_case(get_string(str)));
+}
+
+void *
+string_trim(wasm_exec_env_t exec_env, void *ctx, void *str)
+{
+    return new_string_result(exec_env, str, wasm_string_trim(get_string(str)));
+}
+
+/* clang-format off */
+#define REG_NATIVE_FUNC(func_name, signature) \
+    { #func_name, func_name, signature, NULL }
+
+static NativeSymbol native_symbols[] = {
+    REG_NATIVE_FUNC(string_indexOf, "(rrr)F"),
+    REG_NATIVE_FUNC(string_lastIndexOf, "(rrr)F"),
+    REG_NATIVE_FUNC(string_search, "(rrr)F"),
+    REG_NATIVE_FUNC(string_replace, "(rrrr)r"),
+    REG_NATIVE_FUNC(string_split, "(rrr)r"),
+    REG_NATIVE_FUNC(string_toLowerCase, "(rr)r"),
+    REG_NATIVE_FUNC(string_toUpperCase, "(rr)r"),
+    REG_NATIVE_FUNC(string_trim, "(rr)r"),
+};
+/* clang-format on */
+
+uint32_t
+get_lib_string_symbols(char **p_module_name, NativeSymbol **p_native_symbols)
+{
+    *p_module_name = "env";
+    *p_native_symbols = native_symbols;
+    return sizeof(native_symbols) / sizeof(NativeSymbol);
+}
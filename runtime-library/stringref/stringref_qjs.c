@@ -6,6 +6,7 @@
 #include "string_object.h"
 #include "quickjs.h"
 #include "dynamic/type.h"
+#include "stringref_qjs.h"
 
 static JSValue
 invoke_method(JSValue obj, const char *method, int argc, JSValue *args)
@@ -23,12 +24,575 @@ invoke_method(JSValue obj, const char *method, int argc, JSValue *args)
     return ret;
 }
 
+/******************* string nodes *****************/
+
+/* Strings created by string.concat and string slicing are nodes until their
+ * content is needed as a QuickJS string:
+ *  - a rope references both operands of a concatenation, so building a
+ *    string piece by piece doesn't copy the prefix on every step
+ *  - a slice references the storage of its parent, so slicing a large
+ *    buffer doesn't copy every piece
+ * The nodes and the QuickJS strings share the WASMString handle, a node is
+ * told apart by a marker at the place of the reference count. */
+#define STRING_NODE_MARKER INT32_MIN
+/* shorter results are concatenated at once */
+#define ROPE_MIN_LENGTH 64
+/* deeper ropes are flattened when they are created */
+#define ROPE_MAX_DEPTH 256
+/* shorter slices are copied, so a small slice doesn't keep a large parent
+ * alive */
+#define SLICE_MIN_LENGTH 32
+
+typedef enum StringNodeKind {
+    STRING_NODE_ROPE,
+    STRING_NODE_SLICE,
+} StringNodeKind;
+
+typedef struct WASMStringNode {
+    int32 marker;
+    int32 ref_count;
+    StringNodeKind kind;
+    uint32 len;
+    /* rope: released once the rope is flattened */
+    WASMString left;
+    WASMString right;
+    uint32 depth;
+    /* rope: upper bound of the leaves, children may be flattened later */
+    uint32 leaf_count;
+    /* slice: a QuickJS string and the code unit offset in it */
+    JSValue parent;
+    uint32 start;
+    /* JS_UNDEFINED before the node is flattened */
+    JSValue flat;
+} WASMStringNode;
+
+static inline WASMStringNode *
+get_string_node(WASMString str_obj)
+{
+    return *(int32 *)str_obj == STRING_NODE_MARKER ? (WASMStringNode *)str_obj
+                                                   : NULL;
+}
+
+/* a rope which is not flattened yet */
+static inline WASMStringNode *
+get_pending_rope(WASMString str_obj)
+{
+    WASMStringNode *node = get_string_node(str_obj);
+
+    return node && node->kind == STRING_NODE_ROPE && JS_IsUndefined(node->flat)
+               ? node
+               : NULL;
+}
+
+static uint32
+get_string_length(WASMString str_obj)
+{
+    WASMStringNode *node = get_string_node(str_obj);
+
+    return node ? node->len : ((QJSString *)str_obj)->len;
+}
+
+static void
+dup_string(WASMString str_obj)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    WASMStringNode *node = get_string_node(str_obj);
+
+    if (node) {
+        node->ref_count++;
+    }
+    else {
+        JS_DupValue(dyn_ctx->js_ctx, JS_MKPTR(JS_TAG_STRING, str_obj));
+    }
+}
+
+static WASMStringNode *
+new_string_node(StringNodeKind kind, uint32 len)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    WASMStringNode *node = js_malloc(dyn_ctx->js_ctx, sizeof(WASMStringNode));
+
+    if (!node) {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(WASMStringNode));
+    node->marker = STRING_NODE_MARKER;
+    node->ref_count = 1;
+    node->kind = kind;
+    node->len = len;
+    node->leaf_count = 1;
+    node->parent = JS_UNDEFINED;
+    node->flat = JS_UNDEFINED;
+    return node;
+}
+
+/******************* encoding *****************/
+
+/* number of the bytes with the high bit set, counted a word at a time */
+static uint32
+count_high_bit_bytes(const uint8 *bytes, uint32 len)
+{
+    const uint64 ones = 0x0101010101010101ULL;
+    uint64 word;
+    uint32 count = 0, i = 0;
+
+    for (; i + sizeof(uint64) <= len; i += sizeof(uint64)) {
+        memcpy(&word, bytes + i, sizeof(uint64));
+        /* move the high bits to the low bit of each byte and sum them in
+         * the top byte */
+        count += (uint32)((((word >> 7) & ones) * ones) >> 56);
+    }
+    for (; i < len; i++) {
+        count += bytes[i] >> 7;
+    }
+
+    return count;
+}
+
+static inline bool
+is_high_surrogate(uint32 c)
+{
+    return c >= 0xD800 && c < 0xDC00;
+}
+
+static inline bool
+is_low_surrogate(uint32 c)
+{
+    return c >= 0xDC00 && c < 0xE000;
+}
+
+/* write the UTF-8 sequence of code point c to out if it isn't NULL, and
+ * return its size */
+static inline uint32
+put_utf8(uint8 *out, uint32 c)
+{
+    if (c < 0x80) {
+        if (out) {
+            out[0] = (uint8)c;
+        }
+        return 1;
+    }
+    if (c < 0x800) {
+        if (out) {
+            out[0] = (uint8)(0xC0 | (c >> 6));
+            out[1] = (uint8)(0x80 | (c & 0x3F));
+        }
+        return 2;
+    }
+    if (c < 0x10000) {
+        if (out) {
+            out[0] = (uint8)(0xE0 | (c >> 12));
+            out[1] = (uint8)(0x80 | ((c >> 6) & 0x3F));
+            out[2] = (uint8)(0x80 | (c & 0x3F));
+        }
+        return 3;
+    }
+    if (out) {
+        out[0] = (uint8)(0xF0 | (c >> 18));
+        out[1] = (uint8)(0x80 | ((c >> 12) & 0x3F));
+        out[2] = (uint8)(0x80 | ((c >> 6) & 0x3F));
+        out[3] = (uint8)(0x80 | (c & 0x3F));
+    }
+    return 4;
+}
+
+/* UTF-8 of the 8-bit characters, runs of ASCII are copied a word at a
+ * time */
+static uint32
+encode_latin1_utf8(const uint8 *chars, uint32 len, uint8 *out)
+{
+    const uint64 high_bits = 0x8080808080808080ULL;
+    uint64 word;
+    uint32 i = 0, size = 0;
+
+    while (i < len) {
+        if (i + sizeof(uint64) <= len) {
+            memcpy(&word, chars + i, sizeof(uint64));
+            if (!(word & high_bits)) {
+                memcpy(out + size, &word, sizeof(uint64));
+                i += sizeof(uint64);
+                size += sizeof(uint64);
+                continue;
+            }
+        }
+        size += put_utf8(out + size, chars[i++]);
+    }
+
+    return size;
+}
+
+/* UTF-8 of the code units [pos, end), written to out if it isn't NULL.
+ * Lone surrogates fail in UTF-8, are replaced by U+FFFD in lossy UTF-8 and
+ * are kept in WTF-8. */
+static int32
+encode_wide_utf8(const uint16 *chars, uint32 pos, uint32 end, uint8 *out,
+                 EncodingFlag flag)
+{
+    uint64 size = 0;
+    uint32 i, c;
+
+    for (i = pos; i < end; i++) {
+        c = chars[i];
+        if (is_high_surrogate(c) && i + 1 < end
+            && is_low_surrogate(chars[i + 1])) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (chars[i + 1] - 0xDC00);
+            i++;
+        }
+        else if (is_high_surrogate(c) || is_low_surrogate(c)) {
+            if (flag == UTF8) {
+                return -1;
+            }
+            if (flag == LOSSY_UTF8) {
+                c = 0xFFFD;
+            }
+        }
+        size += put_utf8(out ? out + size : NULL, c);
+    }
+
+    return size > INT32_MAX ? -1 : (int32)size;
+}
+
+/******************* string data *****************/
+
+/* The code units of a string. A slice reads the storage of its parent, and
+ * other strings are flattened to get their storage. */
+typedef struct StringData {
+    QJSString *str;
+    uint32 start;
+    uint32 len;
+} StringData;
+
+static JSValue
+get_js_string(WASMString str_obj);
+
+static uint32
+wtf8_offset_to_unit_pos(JSValue js_str, uint32 byte_pos, uint32 *p_byte_pos);
+
+static bool
+get_string_data(WASMString str_obj, StringData *data)
+{
+    WASMStringNode *node = get_string_node(str_obj);
+    JSValue js_str;
+
+    if (node && node->kind == STRING_NODE_SLICE
+        && JS_IsUndefined(node->flat)) {
+        data->str = JS_VALUE_GET_PTR(node->parent);
+        data->start = node->start;
+        data->len = node->len;
+        return true;
+    }
+
+    js_str = get_js_string(str_obj);
+    if (JS_IsException(js_str)) {
+        return false;
+    }
+    data->str = JS_VALUE_GET_PTR(js_str);
+    data->start = 0;
+    data->len = data->str->len;
+    return true;
+}
+
+static inline const uint8 *
+get_data_str8(const StringData *data)
+{
+    return data->str->u.str8 + data->start;
+}
+
+static inline const uint16 *
+get_data_str16(const StringData *data)
+{
+    return data->str->u.str16 + data->start;
+}
+
+static inline uint32
+get_code_unit(const StringData *data, uint32 pos)
+{
+    return data->str->is_wide_char ? get_data_str16(data)[pos]
+                                   : get_data_str8(data)[pos];
+}
+
+/* number of the code units of the code point at pos */
+static inline uint32
+get_code_point_units(const StringData *data, uint32 pos)
+{
+    return data->str->is_wide_char && pos + 1 < data->len
+                   && is_high_surrogate(get_data_str16(data)[pos])
+                   && is_low_surrogate(get_data_str16(data)[pos + 1])
+               ? 2
+               : 1;
+}
+
+/* UTF-8 of the code units [pos, end) of data, see encode_wide_utf8 */
+static int32
+encode_data_utf8(const StringData *data, uint32 pos, uint32 end, uint8 *out,
+                 EncodingFlag flag)
+{
+    if (data->str->is_wide_char) {
+        return encode_wide_utf8(get_data_str16(data), pos, end, out, flag);
+    }
+
+    return out ? encode_latin1_utf8(get_data_str8(data) + pos, end - pos, out)
+               : end - pos
+                     + count_high_bit_bytes(get_data_str8(data) + pos,
+                                            end - pos);
+}
+
+/* whether the code units are all below 256, checked a word at a time */
+static bool
+is_latin1_wtf16(const uint16 *units, uint32 len)
+{
+    const uint64 high_bytes = 0xFF00FF00FF00FF00ULL;
+    uint64 word;
+    uint32 i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        memcpy(&word, units + i, sizeof(uint64));
+        if (word & high_bytes) {
+            return false;
+        }
+    }
+    for (; i < len; i++) {
+        if (units[i] > 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Allocate a string like js_alloc_string in quickjs.c, so it is released by
+ * JS_FreeValue. The characters of 8-bit strings are null-terminated. */
+static QJSString *
+alloc_js_string(uint32 len, bool is_wide_char)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    QJSString *str;
+
+    if (len > QJS_STRING_LEN_MAX) {
+        JS_ThrowRangeError(dyn_ctx->js_ctx, "invalid string length");
+        return NULL;
+    }
+
+    str = js_malloc(dyn_ctx->js_ctx, sizeof(QJSString) + (len << is_wide_char)
+                                         + 1 - is_wide_char);
+    if (!str) {
+        return NULL;
+    }
+
+    str->ref_count = 1;
+    str->len = len;
+    str->is_wide_char = is_wide_char;
+    str->hash = 0;
+    str->atom_type = 0;
+    str->hash_next = 0;
+    if (!is_wide_char) {
+        str->u.str8[len] = '\0';
+    }
+    return str;
+}
+
+static JSValue
+new_latin1_string(const uint8 *chars, uint32 len)
+{
+    QJSString *str = alloc_js_string(len, false);
+
+    if (!str) {
+        return JS_EXCEPTION;
+    }
+
+    bh_memcpy_s(str->u.str8, len, chars, len);
+    return JS_MKPTR(JS_TAG_STRING, str);
+}
+
+/* an 8-bit string if the code units allow it */
+static JSValue
+new_wtf16_string(const uint16 *units, uint32 len)
+{
+    bool is_wide_char = !is_latin1_wtf16(units, len);
+    QJSString *str = alloc_js_string(len, is_wide_char);
+    uint32 i;
+
+    if (!str) {
+        return JS_EXCEPTION;
+    }
+
+    if (is_wide_char) {
+        bh_memcpy_s(str->u.str16, len * sizeof(uint16), units,
+                    len * sizeof(uint16));
+    }
+    else {
+        for (i = 0; i < len; i++) {
+            str->u.str8[i] = (uint8)units[i];
+        }
+    }
+    return JS_MKPTR(JS_TAG_STRING, str);
+}
+
+/* copy the code units of data to a new QuickJS string */
+static JSValue
+new_js_string(const StringData *data)
+{
+    return data->str->is_wide_char
+               ? new_wtf16_string(get_data_str16(data), data->len)
+               : new_latin1_string(get_data_str8(data), data->len);
+}
+
+/******************* flattening *****************/
+
+/* join the strings with an empty separator, the string buffer of join grows
+ * geometrically, while String.prototype.concat copies the result for every
+ * argument */
+static JSValue
+join_js_strings(JSValue *strs, uint32 count)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    JSContext *js_ctx = dyn_ctx->js_ctx;
+    JSValue arr, sep, res;
+    uint32 i;
+
+    arr = JS_NewArray(js_ctx);
+    if (JS_IsException(arr)) {
+        return arr;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (JS_SetPropertyUint32(js_ctx, arr, i,
+                                 JS_DupValue(js_ctx, strs[i]))
+            < 0) {
+            JS_FreeValue(js_ctx, arr);
+            return JS_EXCEPTION;
+        }
+    }
+
+    sep = JS_NewStringLen(js_ctx, "", 0);
+    res = invoke_method(arr, "join", 1, &sep);
+    JS_FreeValue(js_ctx, sep);
+    JS_FreeValue(js_ctx, arr);
+
+    return res;
+}
+
+static bool
+flatten_rope(WASMStringNode *rope)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    JSContext *js_ctx = dyn_ctx->js_ctx;
+    /* the depth bounds the right children waiting to be visited */
+    WASMString stack[ROPE_MAX_DEPTH + 1];
+    WASMStringNode *node;
+    WASMString str_obj;
+    JSValue *leaves, res;
+    uint32 stack_top = 0, leaf_count = 0;
+
+    leaves = js_malloc(js_ctx, sizeof(JSValue) * rope->leaf_count);
+    if (!leaves) {
+        return false;
+    }
+
+    str_obj = (WASMString)rope;
+    while (true) {
+        if ((node = get_pending_rope(str_obj))) {
+            stack[stack_top++] = node->right;
+            str_obj = node->left;
+            continue;
+        }
+
+        leaves[leaf_count] = get_js_string(str_obj);
+        if (JS_IsException(leaves[leaf_count++])) {
+            js_free(js_ctx, leaves);
+            return false;
+        }
+
+        if (stack_top == 0) {
+            break;
+        }
+        str_obj = stack[--stack_top];
+    }
+
+    res = join_js_strings(leaves, leaf_count);
+    js_free(js_ctx, leaves);
+    if (JS_IsException(res)) {
+        return false;
+    }
+
+    rope->flat = res;
+    wasm_string_destroy(rope->left);
+    wasm_string_destroy(rope->right);
+    rope->left = rope->right = NULL;
+    return true;
+}
+
+static bool
+flatten_slice(WASMStringNode *slice)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    StringData data = { JS_VALUE_GET_PTR(slice->parent), slice->start,
+                        slice->len };
+    JSValue res = new_js_string(&data);
+
+    if (JS_IsException(res)) {
+        return false;
+    }
+
+    slice->flat = res;
+    JS_FreeValue(dyn_ctx->js_ctx, slice->parent);
+    slice->parent = JS_UNDEFINED;
+    return true;
+}
+
+/* Get the QuickJS string of str_obj, a node is flattened on the first call.
+ * The result is borrowed from str_obj, it is JS_EXCEPTION if the node can't
+ * be flattened. */
+static JSValue
+get_js_string(WASMString str_obj)
+{
+    WASMStringNode *node = get_string_node(str_obj);
+
+    if (!node) {
+        return JS_MKPTR(JS_TAG_STRING, str_obj);
+    }
+
+    if (JS_IsUndefined(node->flat)
+        && !(node->kind == STRING_NODE_ROPE ? flatten_rope(node)
+                                            : flatten_slice(node))) {
+        return JS_EXCEPTION;
+    }
+    return node->flat;
+}
+
+/* used by libdyntype to box a stringref as a dynamic string */
+void *
+wasm_string_flatten(const void *str_obj)
+{
+    JSValue js_str = get_js_string((WASMString)str_obj);
+
+    return JS_IsException(js_str) ? NULL : JS_VALUE_GET_PTR(js_str);
+}
+
 /******************* gc finalizer *****************/
 void
 wasm_string_destroy(WASMString str_obj)
 {
     DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSValue js_str = JS_MKPTR(JS_TAG_STRING, (void *)str_obj);
+    WASMStringNode *node = get_string_node(str_obj);
+    JSValue js_str;
+
+    if (node) {
+        if (--node->ref_count > 0) {
+            return;
+        }
+        if (node->left) {
+            wasm_string_destroy(node->left);
+            wasm_string_destroy(node->right);
+        }
+        JS_FreeValue(dyn_ctx->js_ctx, node->parent);
+        JS_FreeValue(dyn_ctx->js_ctx, node->flat);
+        js_free(dyn_ctx->js_ctx, node);
+        return;
+    }
+
+    js_str = JS_MKPTR(JS_TAG_STRING, (void *)str_obj);
     JS_FreeValue(dyn_ctx->js_ctx, js_str);
 }
 /******************* opcode functions *****************/
@@ -38,7 +602,36 @@ WASMString
 wasm_string_new_const(const char *str)
 {
     DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSValue js_str = JS_NewString(dyn_ctx->js_ctx, str);
+    JSContext *js_ctx = dyn_ctx->js_ctx;
+    uint32 slot = (uint32)(((uintptr_t)str * 2654435761u) >> 8)
+                  % DYN_STRING_CONST_CACHE_SIZE;
+    DynStringConstCacheEntry *entry = &dyn_ctx->string_const_cache[slot];
+    JSValue js_str;
+    char *bytes;
+    size_t len;
+
+    /* the same constant is the same string, so string.eq compares it by
+     * the address */
+    if (entry->addr == str && strcmp(entry->bytes, str) == 0) {
+        return JS_VALUE_GET_PTR(JS_DupValue(js_ctx, entry->str));
+    }
+
+    len = strlen(str);
+    js_str = JS_NewStringLen(js_ctx, str, len);
+    if (JS_IsException(js_str)) {
+        return NULL;
+    }
+
+    if ((bytes = js_malloc(js_ctx, len + 1))) {
+        memcpy(bytes, str, len + 1);
+        if (entry->bytes) {
+            js_free(js_ctx, entry->bytes);
+            JS_FreeValue(js_ctx, entry->str);
+        }
+        entry->addr = str;
+        entry->bytes = bytes;
+        entry->str = JS_DupValue(js_ctx, js_str);
+    }
 
     return JS_VALUE_GET_PTR(js_str);
 }
@@ -51,23 +644,72 @@ WASMString
 wasm_string_new_with_encoding(void *addr, uint32 count, EncodingFlag flag)
 {
     DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSValue js_str = JS_NewStringLen(dyn_ctx->js_ctx, addr, count);
+    JSValue js_str;
 
-    return JS_VALUE_GET_PTR(js_str);
+    /* count is the number of code units */
+    if (flag == WTF16) {
+        js_str = new_wtf16_string(addr, count);
+    }
+    /* copy ASCII, QuickJS decodes the other UTF-8 */
+    else if (count_high_bit_bytes(addr, count) == 0) {
+        js_str = new_latin1_string(addr, count);
+    }
+    else {
+        js_str = JS_NewStringLen(dyn_ctx->js_ctx, addr, count);
+    }
+
+    return JS_IsException(js_str) ? NULL : JS_VALUE_GET_PTR(js_str);
 }
 
+/* The UTF-8 size of 8-bit strings is cached in the hash and hash_next fields
+ * of the QuickJS string header, see wasm_string_measure. This relies on the
+ * JSString layout of quickjs.c copied to QJSString, and on QuickJS reading
+ * these fields only for atoms (atom_type != 0): a string turned into an atom
+ * gets both fields and atom_type overwritten, so a cached size is never
+ * mistaken for an atom hash. Check the layout again when QuickJS is
+ * upgraded. */
+_Static_assert(offsetof(QJSString, hash_next) == 3 * sizeof(uint32_t),
+               "hash_next must follow the hash/atom_type word of JSString");
+_Static_assert(offsetof(QJSString, u) == 4 * sizeof(uint32_t),
+               "QJSString must have the header size of JSString");
+
 /* string.measure */
 /* stringview_wtf16.length */
 int32
 wasm_string_measure(WASMString str_obj, EncodingFlag flag)
 {
-    DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSValue js_str = JS_MKPTR(JS_TAG_STRING, str_obj);
-    JSValue length;
+    StringData data;
+    QJSString *str;
+    uint32 size;
+
+    /* read from the string header, or from the node without flattening it */
+    if (flag == WTF16) {
+        return get_string_length(str_obj);
+    }
+
+    if (!get_string_data(str_obj, &data)) {
+        return -1;
+    }
+    str = data.str;
+
+    if (str->is_wide_char || data.len != str->len) {
+        return encode_data_utf8(&data, 0, data.len, NULL, flag);
+    }
 
-    length = JS_GetPropertyStr(dyn_ctx->js_ctx, js_str, "length");
+    /* the UTF-8 size of non-atom 8-bit strings is cached in hash_next, plus
+     * one to tell it from the initial 0. QuickJS may append to a string in
+     * place when it holds the only reference, so the length it was measured
+     * at is kept in hash. */
+    if (str->atom_type == 0 && str->hash_next != 0 && str->hash == str->len) {
+        return str->hash_next - 1;
+    }
 
-    return JS_VALUE_GET_INT(length);
+    size = str->len + count_high_bit_bytes(str->u.str8, str->len);
+    if (str->atom_type == 0) {
+        str->hash = str->len;
+        str->hash_next = size + 1;
+    }
+    return size;
 }
 
 /* stringview_wtf16.length */
@@ -87,49 +729,188 @@ int32
 wasm_string_encode(WASMString str_obj, uint32 pos, uint32 count, void *addr,
                    uint32 *next_pos, EncodingFlag flag)
 {
-    DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSValue js_str = JS_MKPTR(JS_TAG_STRING, str_obj);
-    const char *str = NULL;
-    size_t str_len = 0;
+    StringData data;
+    JSValue js_str;
+    uint32 end, end_byte, i;
+    int32 size;
 
-    str = JS_ToCStringLen(dyn_ctx->js_ctx, &str_len, js_str);
+    /* stringview_wtf8 is the only caller taking next_pos, its pos and count
+     * are in bytes, they are mapped to the last code point boundaries not
+     * after them */
+    if (next_pos && flag != WTF16) {
+        js_str = get_js_string(str_obj);
+        if (JS_IsException(js_str)) {
+            return -1;
+        }
+        end = count > UINT32_MAX - pos ? UINT32_MAX : pos + count;
+        pos = wtf8_offset_to_unit_pos(js_str, pos, NULL);
+        end = wtf8_offset_to_unit_pos(js_str, end, &end_byte);
 
-    /* If addr == NULL, just calculate the required length */
-    if (addr) {
-        bh_memcpy_s(addr, str_len, str, str_len);
+        if (!get_string_data(str_obj, &data)) {
+            return -1;
+        }
+        size = encode_data_utf8(&data, pos, end, addr, flag);
+        if (size >= 0) {
+            *next_pos = end_byte;
+        }
+        return size;
     }
 
-    if (next_pos) {
-        *next_pos = pos + count;
+    if (!get_string_data(str_obj, &data)) {
+        return -1;
     }
 
-    JS_FreeCString(dyn_ctx->js_ctx, str);
-    return str_len;
+    /* pos and count are in WTF-16 code units */
+    if (pos > data.len) {
+        pos = data.len;
+    }
+    end = count > data.len - pos ? data.len : pos + count;
+
+    if (flag == WTF16) {
+        /* If addr == NULL, just calculate the required length */
+        if (addr && data.str->is_wide_char) {
+            bh_memcpy_s(addr, (end - pos) * sizeof(uint16),
+                        get_data_str16(&data) + pos,
+                        (end - pos) * sizeof(uint16));
+        }
+        else if (addr) {
+            for (i = pos; i < end; i++) {
+                ((uint16 *)addr)[i - pos] = get_data_str8(&data)[i];
+            }
+        }
+        size = end - pos;
+    }
+    else {
+        /* don't split a surrogate pair at the end of the range */
+        if (end > pos && end < data.len
+            && get_code_point_units(&data, end - 1) == 2) {
+            end = end - 1 > pos ? end - 1 : end + 1;
+        }
+        size = encode_data_utf8(&data, pos, end, addr, flag);
+    }
+
+    if (size >= 0 && next_pos) {
+        *next_pos = end;
+    }
+    return size;
 }
 
 /* string.concat */
 WASMString
 wasm_string_concat(WASMString str_obj1, WASMString str_obj2)
 {
-    JSValue js_str1 = JS_MKPTR(JS_TAG_STRING, str_obj1);
-    JSValue js_str2 = JS_MKPTR(JS_TAG_STRING, str_obj2);
-    JSValue js_str_res;
+    WASMStringNode *left = get_pending_rope(str_obj1);
+    WASMStringNode *right = get_pending_rope(str_obj2);
+    uint32 len1 = get_string_length(str_obj1);
+    uint32 len2 = get_string_length(str_obj2);
+    WASMStringNode *rope;
+    JSValue js_str1, js_str2, js_str_res;
+
+    if (len2 == 0) {
+        dup_string(str_obj1);
+        return str_obj1;
+    }
+    if (len1 == 0) {
+        dup_string(str_obj2);
+        return str_obj2;
+    }
+
+    /* pending ropes are never shorter than ROPE_MIN_LENGTH */
+    if (len1 + len2 < ROPE_MIN_LENGTH) {
+        js_str1 = get_js_string(str_obj1);
+        js_str2 = get_js_string(str_obj2);
+        if (JS_IsException(js_str1) || JS_IsException(js_str2)) {
+            return NULL;
+        }
+        js_str_res = invoke_method(js_str1, "concat", 1, &js_str2);
+        return JS_IsException(js_str_res) ? NULL
+                                          : JS_VALUE_GET_PTR(js_str_res);
+    }
+
+    rope = new_string_node(STRING_NODE_ROPE, len1 + len2);
+    if (!rope) {
+        return NULL;
+    }
 
-    js_str_res = invoke_method(js_str1, "concat", 1, &js_str2);
-    return JS_VALUE_GET_PTR(js_str_res);
+    rope->depth = 1;
+    if (left && left->depth >= rope->depth) {
+        rope->depth = left->depth + 1;
+    }
+    if (right && right->depth >= rope->depth) {
+        rope->depth = right->depth + 1;
+    }
+    rope->leaf_count =
+        (left ? left->leaf_count : 1) + (right ? right->leaf_count : 1);
+    dup_string(str_obj1);
+    dup_string(str_obj2);
+    rope->left = str_obj1;
+    rope->right = str_obj2;
+
+    if (rope->depth > ROPE_MAX_DEPTH && !flatten_rope(rope)) {
+        wasm_string_destroy((WASMString)rope);
+        return NULL;
+    }
+
+    return (WASMString)rope;
 }
 
 /* string.eq */
 int32
 wasm_string_eq(WASMString str_obj1, WASMString str_obj2)
 {
-    JSValue js_str1 = JS_MKPTR(JS_TAG_STRING, str_obj1);
-    JSValue js_str2 = JS_MKPTR(JS_TAG_STRING, str_obj2);
-    JSValue res;
+    StringData data1, data2;
+    const StringData *narrow, *wide;
+    uint32_t i;
+
+    if (str_obj1 == str_obj2) {
+        return 1;
+    }
+
+    /* reject before flattening the nodes */
+    if (get_string_length(str_obj1) != get_string_length(str_obj2)) {
+        return 0;
+    }
+
+    if (!get_string_data(str_obj1, &data1)
+        || !get_string_data(str_obj2, &data2)) {
+        return 0;
+    }
+
+    if (data1.str == data2.str && data1.start == data2.start) {
+        return 1;
+    }
+
+    /* the hash is only computed for atoms, which are never sliced */
+    if (data1.str->atom_type != 0
+        && data1.str->atom_type == data2.str->atom_type
+        && data1.len == data1.str->len && data2.len == data2.str->len
+        && data1.str->hash != data2.str->hash) {
+        return 0;
+    }
 
-    res = invoke_method(js_str1, "localeCompare", 1, &js_str2);
+    if (data1.str->is_wide_char == data2.str->is_wide_char) {
+        return memcmp(data1.str->is_wide_char
+                          ? (const void *)get_data_str16(&data1)
+                          : (const void *)get_data_str8(&data1),
+                      data2.str->is_wide_char
+                          ? (const void *)get_data_str16(&data2)
+                          : (const void *)get_data_str8(&data2),
+                      (size_t)data1.len << data1.str->is_wide_char)
+                       == 0
+                   ? 1
+                   : 0;
+    }
 
-    return JS_VALUE_GET_INT(res) == 0 ? 1 : 0;
+    /* a wide string may still hold 8-bit characters only */
+    narrow = data1.str->is_wide_char ? &data2 : &data1;
+    wide = data1.str->is_wide_char ? &data1 : &data2;
+    for (i = 0; i < narrow->len; i++) {
+        if (get_data_str8(narrow)[i] != get_data_str16(wide)[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
 }
 
 /* string.is_usv_sequence */
@@ -144,12 +925,62 @@ wasm_string_is_usv_sequence(WASMString str_obj)
 /* string.as_iter */
 WASMString
 wasm_string_create_view(WASMString str_obj, StringViewType type)
+{
+    dup_string(str_obj);
+    return str_obj;
+}
+
+/* Map the WTF-8 offset byte_pos of js_str to a code unit position, the
+ * offset is rounded down to a code point boundary and returned by
+ * p_byte_pos */
+static uint32
+wtf8_offset_to_unit_pos(JSValue js_str, uint32 byte_pos, uint32 *p_byte_pos)
 {
     DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSValue js_str1 = JS_MKPTR(JS_TAG_STRING, str_obj);
+    DynWTF8Cursor *cursor = &dyn_ctx->wtf8_cursor;
+    QJSString *str = JS_VALUE_GET_PTR(js_str);
+    StringData data = { str, 0, str->len };
+    uint32 unit_pos = 0, offset = 0, units, size;
 
-    JS_DupValue(dyn_ctx->js_ctx, js_str1);
-    return str_obj;
+    /* the offsets of ASCII strings are the code unit positions, the measure
+     * of 8-bit strings is cached */
+    if (!str->is_wide_char
+        && wasm_string_measure((WASMString)str, WTF8) == (int32)str->len) {
+        unit_pos = byte_pos < str->len ? byte_pos : str->len;
+        if (p_byte_pos) {
+            *p_byte_pos = unit_pos;
+        }
+        return unit_pos;
+    }
+
+    if (JS_VALUE_GET_PTR(cursor->str) == (void *)str
+        && cursor->byte_pos <= byte_pos) {
+        unit_pos = cursor->unit_pos;
+        offset = cursor->byte_pos;
+    }
+
+    while (unit_pos < str->len) {
+        units = get_code_point_units(&data, unit_pos);
+        size =
+            units == 2 ? 4 : put_utf8(NULL, get_code_unit(&data, unit_pos));
+        if (offset + size > byte_pos) {
+            break;
+        }
+        offset += size;
+        unit_pos += units;
+    }
+
+    if (JS_VALUE_GET_PTR(cursor->str) != (void *)str) {
+        JS_FreeValue(dyn_ctx->js_ctx, cursor->str);
+        cursor->str = JS_DupValue(dyn_ctx->js_ctx, js_str);
+    }
+    cursor->byte_pos = offset;
+    cursor->unit_pos = unit_pos;
+
+    if (p_byte_pos) {
+        *p_byte_pos = offset;
+    }
+    return unit_pos;
 }
 
 /* stringview_wtf8.advance */
@@ -158,7 +989,34 @@ int32
 wasm_string_advance(WASMString str_obj, uint32 pos, uint32 count,
                     uint32 *consumed)
 {
-    return 0;
+    StringData data;
+    JSValue js_str;
+    uint32 n = 0, byte_pos;
+
+    /* stringview_iter, pos is a code unit position and count is the number
+     * of code points */
+    if (consumed) {
+        if (!get_string_data(str_obj, &data)) {
+            return -1;
+        }
+        while (n < count && pos < data.len) {
+            pos += get_code_point_units(&data, pos);
+            n++;
+        }
+        *consumed = n;
+        return pos;
+    }
+
+    /* stringview_wtf8, pos and count are in bytes, return the last code
+     * point boundary not after pos + count */
+    js_str = get_js_string(str_obj);
+    if (JS_IsException(js_str)) {
+        return -1;
+    }
+    wtf8_offset_to_unit_pos(js_str,
+                            count > UINT32_MAX - pos ? UINT32_MAX : pos + count,
+                            &byte_pos);
+    return byte_pos;
 }
 
 /* stringview_wtf8.slice */
@@ -168,29 +1026,88 @@ WASMString
 wasm_string_slice(WASMString str_obj, uint32 start, uint32 end,
                   StringViewType type)
 {
-    DynTypeContext *dyn_ctx = dyntype_get_context();
-    JSContext *js_ctx = dyn_ctx->js_ctx;
-    JSValue js_str = JS_MKPTR(JS_TAG_STRING, str_obj);
-    JSValue args[2] = { JS_NewFloat64(js_ctx, start),
-                        JS_NewFloat64(js_ctx, end) };
-    JSValue js_str_res;
+    WASMStringNode *slice;
+    StringData data;
+    JSValue js_str;
+
+    /* the positions of WTF-8 views are byte offsets */
+    if (type == STRING_VIEW_WTF8) {
+        js_str = get_js_string(str_obj);
+        if (JS_IsException(js_str)) {
+            return NULL;
+        }
+        start = wtf8_offset_to_unit_pos(js_str, start, NULL);
+        end = wtf8_offset_to_unit_pos(js_str, end, NULL);
+    }
+
+    if (!get_string_data(str_obj, &data)) {
+        return NULL;
+    }
+
+    if (end > data.len) {
+        end = data.len;
+    }
+    if (start > end) {
+        start = end;
+    }
+
+    if (start == 0 && end == data.len) {
+        dup_string(str_obj);
+        return str_obj;
+    }
+
+    data.start += start;
+    data.len = end - start;
+    if (data.len < SLICE_MIN_LENGTH) {
+        js_str = new_js_string(&data);
+        return JS_IsException(js_str) ? NULL : JS_VALUE_GET_PTR(js_str);
+    }
 
-    js_str_res = invoke_method(js_str, "slice", 2, args);
-    return JS_VALUE_GET_PTR(js_str_res);
+    /* a slice of a slice references the same parent */
+    slice = new_string_node(STRING_NODE_SLICE, data.len);
+    if (!slice) {
+        return NULL;
+    }
+    slice->parent = JS_DupValue(dyntype_get_context()->js_ctx,
+                                JS_MKPTR(JS_TAG_STRING, data.str));
+    slice->start = data.start;
+
+    return (WASMString)slice;
 }
 
 /* stringview_wtf16.get_codeunit */
 int16
 wasm_string_get_wtf16_codeunit(WASMString str_obj, int32 pos)
 {
-    return 0;
+    StringData data;
+
+    if (!get_string_data(str_obj, &data)) {
+        return -1;
+    }
+
+    if (pos < 0 || (uint32)pos >= data.len) {
+        return -1;
+    }
+    return (int16)get_code_unit(&data, pos);
 }
 
 /* stringview_iter.next */
 uint32
 wasm_string_next_codepoint(WASMString str_obj, uint32 pos)
 {
-    return 0;
+    StringData data;
+    uint32 c;
+
+    if (!get_string_data(str_obj, &data) || pos >= data.len) {
+        return (uint32)-1;
+    }
+
+    c = get_code_unit(&data, pos);
+    if (get_code_point_units(&data, pos) == 2) {
+        c = 0x10000 + ((c - 0xD800) << 10)
+            + (get_code_unit(&data, pos + 1) - 0xDC00);
+    }
+    return c;
 }
 
 /* stringview_iter.rewind */
@@ -198,7 +1115,26 @@ uint32
 wasm_string_rewind(WASMString str_obj, uint32 pos, uint32 count,
                    uint32 *consumed)
 {
-    return 0;
+    StringData data;
+    uint32 n = 0;
+
+    if (!get_string_data(str_obj, &data)) {
+        return pos;
+    }
+
+    if (pos > data.len) {
+        pos = data.len;
+    }
+
+    while (n < count && pos > 0) {
+        pos -= pos >= 2 && get_code_point_units(&data, pos - 2) == 2 ? 2 : 1;
+        n++;
+    }
+
+    if (consumed) {
+        *consumed = n;
+    }
+    return pos;
 }
 
 /******************* application functions *****************/
@@ -207,11 +1143,366 @@ wasm_string_dump(WASMString str_obj)
 {
     DynTypeContext *dyn_ctx = dyntype_get_context();
     JSContext *js_ctx = dyn_ctx->js_ctx;
-    JSValue js_str = JS_MKPTR(JS_TAG_STRING, str_obj);
+    JSValue js_str = get_js_string(str_obj);
     const char *str;
     size_t len;
 
+    if (JS_IsException(js_str)) {
+        return;
+    }
+
     str = JS_ToCStringLen(js_ctx, &len, js_str);
     fwrite(str, 1, len, stdout);
     JS_FreeCString(js_ctx, str);
 }
+
+/******************* string search *****************/
+
+/* Horspool is used for needles of at least 4 code units in at least 256 code
+ * units, shorter searches scan for the first code unit of the needle */
+#define HORSPOOL_MIN_NEEDLE 4
+#define HORSPOOL_MIN_HAYSTACK 256
+
+static inline bool
+match_at(const StringData *str, uint32 pos, const StringData *search)
+{
+    uint32 i;
+
+    if (str->str->is_wide_char == search->str->is_wide_char) {
+        return memcmp(str->str->is_wide_char
+                          ? (const void *)(get_data_str16(str) + pos)
+                          : (const void *)(get_data_str8(str) + pos),
+                      search->str->is_wide_char
+                          ? (const void *)get_data_str16(search)
+                          : (const void *)get_data_str8(search),
+                      (size_t)search->len << search->str->is_wide_char)
+               == 0;
+    }
+
+    for (i = 0; i < search->len; i++) {
+        if (get_code_unit(str, pos + i) != get_code_unit(search, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* position of the first code unit c in [pos, end) of data, or end */
+static uint32
+find_code_unit(const StringData *data, uint32 c, uint32 pos, uint32 end)
+{
+    const uint8 *chars, *found;
+    const uint16 *units;
+
+    if (!data->str->is_wide_char) {
+        if (c > 0xFF) {
+            return end;
+        }
+        chars = get_data_str8(data);
+        found = memchr(chars + pos, (int)c, end - pos);
+        return found ? (uint32)(found - chars) : end;
+    }
+
+    units = get_data_str16(data);
+    while (pos < end && units[pos] != c) {
+        pos++;
+    }
+    return pos;
+}
+
+/* the shift table is indexed by the low byte of the code units, a shift is
+ * the smallest of the code units sharing the byte */
+static int32
+horspool_search(const StringData *str, const StringData *search, uint32 pos)
+{
+    uint32 shift[256];
+    uint32 last = search->len - 1, last_unit, c, i;
+
+    for (i = 0; i < 256; i++) {
+        shift[i] = search->len;
+    }
+    for (i = 0; i < last; i++) {
+        shift[get_code_unit(search, i) & 0xFF] = last - i;
+    }
+
+    last_unit = get_code_unit(search, last);
+    while (pos + search->len <= str->len) {
+        c = get_code_unit(str, pos + last);
+        if (c == last_unit && match_at(str, pos, search)) {
+            return pos;
+        }
+        pos += shift[c & 0xFF];
+    }
+
+    return -1;
+}
+
+/* used by the string library of stdlib, return the code unit position of
+ * the first search_obj in str_obj from pos, or -1 */
+int32
+wasm_string_index_of(WASMString str_obj, WASMString search_obj, uint32 pos)
+{
+    StringData str, search;
+    uint32 first, end;
+
+    if (!get_string_data(str_obj, &str)
+        || !get_string_data(search_obj, &search)) {
+        return -1;
+    }
+
+    if (pos > str.len) {
+        pos = str.len;
+    }
+    if (search.len > str.len - pos) {
+        return -1;
+    }
+    if (search.len == 0) {
+        return pos;
+    }
+
+    if (search.len >= HORSPOOL_MIN_NEEDLE
+        && str.len - pos >= HORSPOOL_MIN_HAYSTACK) {
+        return horspool_search(&str, &search, pos);
+    }
+
+    first = get_code_unit(&search, 0);
+    end = str.len - search.len + 1;
+    while ((pos = find_code_unit(&str, first, pos, end)) < end) {
+        if (match_at(&str, pos, &search)) {
+            return pos;
+        }
+        pos++;
+    }
+
+    return -1;
+}
+
+/* used by the string library of stdlib, return the code unit position of
+ * the last search_obj in str_obj starting not after pos, or -1 */
+int32
+wasm_string_last_index_of(WASMString str_obj, WASMString search_obj,
+                          uint32 pos)
+{
+    StringData str, search;
+    uint32 first, i;
+
+    if (!get_string_data(str_obj, &str)
+        || !get_string_data(search_obj, &search)) {
+        return -1;
+    }
+
+    if (search.len > str.len) {
+        return -1;
+    }
+    if (pos > str.len - search.len) {
+        pos = str.len - search.len;
+    }
+    if (search.len == 0) {
+        return pos;
+    }
+
+    first = get_code_unit(&search, 0);
+    for (i = pos + 1; i-- > 0;) {
+        if (get_code_unit(&str, i) == first && match_at(&str, i, &search)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/******************* case conversion and trim *****************/
+
+/* 8-bit characters whose upper case is out of Latin-1 or longer: micro sign,
+ * sharp s and y with diaeresis */
+static inline bool
+is_special_upper_latin1(uint32 c)
+{
+    return c == 0xB5 || c == 0xDF || c == 0xFF;
+}
+
+static inline uint32
+to_case_latin1(uint32 c, bool lower)
+{
+    if (lower) {
+        return (c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7)
+                   ? c + 0x20
+                   : c;
+    }
+    return (c >= 'a' && c <= 'z') || (c >= 0xE0 && c <= 0xFE && c != 0xF7)
+               ? c - 0x20
+               : c;
+}
+
+/* 0x20 in the bytes of the ASCII word which are letters of the other case,
+ * so the word is converted by XOR */
+static inline uint64
+get_ascii_case_mask(uint64 word, bool lower)
+{
+    const uint64 ones = 0x0101010101010101ULL;
+    uint32 first = lower ? 'A' : 'a', last = lower ? 'Z' : 'z';
+    /* the high bit of a byte is set if it is not less than first, and if it
+     * is greater than last */
+    uint64 ge_first = word + ones * (0x80 - first);
+    uint64 gt_last = word + ones * (0x7F - last);
+
+    return ((ge_first ^ gt_last) & (ones * 0x80)) >> 2;
+}
+
+/* position of the first character changed by the case conversion, ASCII is
+ * checked a word at a time */
+static uint32
+find_case_change_latin1(const uint8 *chars, uint32 len, bool lower)
+{
+    const uint64 high_bits = 0x8080808080808080ULL;
+    uint64 word;
+    uint32 i = 0, end;
+
+    while (i < len) {
+        if (i + sizeof(uint64) <= len) {
+            memcpy(&word, chars + i, sizeof(uint64));
+            if (!(word & high_bits) && !get_ascii_case_mask(word, lower)) {
+                i += sizeof(uint64);
+                continue;
+            }
+        }
+        for (end = i + sizeof(uint64) < len ? i + sizeof(uint64) : len;
+             i < end; i++) {
+            if (to_case_latin1(chars[i], lower) != chars[i]
+                || (!lower && is_special_upper_latin1(chars[i]))) {
+                return i;
+            }
+        }
+    }
+
+    return len;
+}
+
+/* convert the case of the 8-bit characters, false if one of them isn't
+ * 8-bit after the conversion */
+static bool
+convert_case_latin1(const uint8 *chars, uint32 len, uint8 *out, bool lower)
+{
+    const uint64 high_bits = 0x8080808080808080ULL;
+    uint64 word;
+    uint32 i = 0;
+
+    while (i < len) {
+        if (i + sizeof(uint64) <= len) {
+            memcpy(&word, chars + i, sizeof(uint64));
+            if (!(word & high_bits)) {
+                word ^= get_ascii_case_mask(word, lower);
+                memcpy(out + i, &word, sizeof(uint64));
+                i += sizeof(uint64);
+                continue;
+            }
+        }
+        if (!lower && is_special_upper_latin1(chars[i])) {
+            return false;
+        }
+        out[i] = (uint8)to_case_latin1(chars[i], lower);
+        i++;
+    }
+
+    return true;
+}
+
+static WASMString
+string_to_case(WASMString str_obj, bool lower)
+{
+    DynTypeContext *dyn_ctx = dyntype_get_context();
+    JSContext *js_ctx = dyn_ctx->js_ctx;
+    StringData data;
+    QJSString *res;
+    JSValue js_str, js_res;
+    uint32 pos;
+
+    if (!get_string_data(str_obj, &data)) {
+        return NULL;
+    }
+
+    if (!data.str->is_wide_char) {
+        pos = find_case_change_latin1(get_data_str8(&data), data.len, lower);
+        if (pos == data.len) {
+            dup_string(str_obj);
+            return str_obj;
+        }
+
+        if (!(res = alloc_js_string(data.len, false))) {
+            return NULL;
+        }
+        memcpy(res->u.str8, get_data_str8(&data), pos);
+        if (convert_case_latin1(get_data_str8(&data) + pos, data.len - pos,
+                                res->u.str8 + pos, lower)) {
+            return (WASMString)res;
+        }
+        JS_FreeValue(js_ctx, JS_MKPTR(JS_TAG_STRING, res));
+    }
+
+    /* QuickJS converts the other strings with its Unicode tables */
+    js_str = get_js_string(str_obj);
+    if (JS_IsException(js_str)) {
+        return NULL;
+    }
+    js_res = invoke_method(js_str, lower ? "toLowerCase" : "toUpperCase", 0,
+                           NULL);
+    if (JS_IsException(js_res)) {
+        return NULL;
+    }
+
+    if (wasm_string_eq(JS_VALUE_GET_PTR(js_res), str_obj)) {
+        JS_FreeValue(js_ctx, js_res);
+        dup_string(str_obj);
+        return str_obj;
+    }
+    return JS_VALUE_GET_PTR(js_res);
+}
+
+/* used by the string library of stdlib, str_obj is returned with its
+ * reference count bumped if the case is not changed */
+WASMString
+wasm_string_to_lower_case(WASMString str_obj)
+{
+    return string_to_case(str_obj, true);
+}
+
+WASMString
+wasm_string_to_upper_case(WASMString str_obj)
+{
+    return string_to_case(str_obj, false);
+}
+
+/* WhiteSpace and LineTerminator of ECMAScript */
+static inline bool
+is_js_space(uint32 c)
+{
+    if (c < 0x80) {
+        return c == ' ' || (c >= 0x09 && c <= 0x0D);
+    }
+    return c == 0xA0 || c == 0x1680 || (c >= 0x2000 && c <= 0x200A)
+           || c == 0x2028 || c == 0x2029 || c == 0x202F || c == 0x205F
+           || c == 0x3000 || c == 0xFEFF;
+}
+
+/* used by the string library of stdlib, the result is a slice of str_obj,
+ * or str_obj with its reference count bumped if there is nothing to trim */
+WASMString
+wasm_string_trim(WASMString str_obj)
+{
+    StringData data;
+    uint32 start = 0, end;
+
+    if (!get_string_data(str_obj, &data)) {
+        return NULL;
+    }
+
+    end = data.len;
+    while (start < end && is_js_space(get_code_unit(&data, start))) {
+        start++;
+    }
+    while (end > start && is_js_space(get_code_unit(&data, end - 1))) {
+        end--;
+    }
+
+    return wasm_string_slice(str_obj, start, end, STRING_VIEW_WTF16);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef __STRINGREF_QJS_H_
+#define __STRINGREF_QJS_H_
+
+#include "string_object.h"
+
+/* APIs provided by the stringref implementation besides the ones required
+ * by WAMR (string_object.h) */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* get the flat JSString of a stringref, a rope is flattened by it, returns
+ * NULL if the flattening failed */
+void *
+wasm_string_flatten(const void *str_obj);
+
+/* the positions are in WTF-16 code units, -1 is returned if search_obj isn't
+ * found */
+int32
+wasm_string_index_of(WASMString str_obj, WASMString search_obj, uint32 pos);
+
+int32
+wasm_string_last_index_of(WASMString str_obj, WASMString search_obj,
+                          uint32 pos);
+
+/* str_obj is returned with its reference count bumped if it isn't changed */
+WASMString
+wasm_string_to_lower_case(WASMString str_obj);
+
+WASMString
+wasm_string_to_upper_case(WASMString str_obj);
+
+WASMString
+wasm_string_trim(WASMString str_obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __STRINGREF_QJS_H_ */
@@ -4,6 +4,7 @@
  */
 
 #include "gc_type.h"
+#include "type_utils.h"
 
 static wasm_struct_obj_t
 check_struct_obj_type(wasm_exec_env_t exec_env, wasm_obj_t obj, int index,
@@ -214,6 +215,266 @@ struct_set_indirect_funcref(wasm_exec_env_t exec_env, wasm_anyref_obj_t obj,
     wasm_struct_obj_set_field(struct_obj, index, &val);
 }
 
+/*
+    inline caches for interface property lookup
+
+    Every interface access site of the generated code gets a site id, the
+    (meta, name, flag) -> (flag_and_index, type) results of the meta lookup
+    are cached per site, up to STRUCT_IC_ENTRIES entries. When a site sees
+    more shapes than that it turns megamorphic and goes through a shared
+    direct-mapped cache of the module instead. The meta of a type is
+    immutable, so the entries never need to be invalidated.
+
+    The name is matched by its contents, not its address: element access
+    sites encode every computed key to the same scratch address of linear
+    memory, so one address stands for many names.
+*/
+#define STRUCT_IC_ENTRIES 4
+#define STRUCT_IC_MEGA_CACHE_SIZE 256
+#define STRUCT_IC_MIN_SITES 64
+
+typedef struct StructICEntry {
+    int32_t meta;
+    uint32_t name_hash;
+    /* copy of the property name */
+    char *name;
+    int32_t flag;
+    int32_t flag_and_index;
+    int32_t prop_type;
+} StructICEntry;
+
+typedef struct StructICSite {
+    uint32_t count;
+    bool megamorphic;
+    StructICEntry entries[STRUCT_IC_ENTRIES];
+} StructICSite;
+
+typedef struct StructICTable {
+    struct StructICTable *next;
+    wasm_module_t module;
+    uint32_t site_count;
+    StructICSite *sites;
+    StructICEntry mega_cache[STRUCT_IC_MEGA_CACHE_SIZE];
+} StructICTable;
+
+static StructICTable *struct_ic_tables = NULL;
+
+static inline bool
+is_struct_ic_entry_matched(const StructICEntry *entry, int32_t meta,
+                           uint32_t name_hash, const char *name, int32_t flag)
+{
+    return entry->meta == meta && entry->flag == flag
+           && entry->name_hash == name_hash && entry->name
+           && strcmp(entry->name, name) == 0;
+}
+
+static StructICTable *
+get_struct_ic_table(wasm_module_t module)
+{
+    StructICTable *table;
+    uint32_t i;
+
+    if (struct_ic_tables && struct_ic_tables->module == module) {
+        return struct_ic_tables;
+    }
+
+    for (table = struct_ic_tables; table; table = table->next) {
+        if (table->module == module) {
+            return table;
+        }
+    }
+
+    if (!(table = wasm_runtime_malloc(sizeof(StructICTable)))) {
+        return NULL;
+    }
+    memset(table, 0, sizeof(StructICTable));
+    table->module = module;
+    for (i = 0; i < STRUCT_IC_MEGA_CACHE_SIZE; i++) {
+        table->mega_cache[i].meta = -1;
+    }
+
+    table->next = struct_ic_tables;
+    struct_ic_tables = table;
+    return table;
+}
+
+static StructICSite *
+get_struct_ic_site(StructICTable *table, uint32_t site_id)
+{
+    StructICSite *sites;
+    uint32_t site_count;
+
+    if (site_id < table->site_count) {
+        return &table->sites[site_id];
+    }
+
+    site_count = table->site_count ? table->site_count : STRUCT_IC_MIN_SITES;
+    while (site_count <= site_id) {
+        site_count <<= 1;
+    }
+
+    if (!(sites = wasm_runtime_malloc(sizeof(StructICSite) * site_count))) {
+        return NULL;
+    }
+    memset(sites, 0, sizeof(StructICSite) * site_count);
+    if (table->sites) {
+        memcpy(sites, table->sites, sizeof(StructICSite) * table->site_count);
+        wasm_runtime_free(table->sites);
+    }
+    table->sites = sites;
+    table->site_count = site_count;
+
+    return &table->sites[site_id];
+}
+
+static bool
+struct_ic_fill_entry(wasm_exec_env_t exec_env, StructICEntry *entry,
+                     int32_t meta, uint32_t name_hash, const char *prop_name,
+                     int32_t flag)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    void *meta_addr = wasm_runtime_addr_app_to_native(module_inst, meta);
+    uint32_t name_len = (uint32_t)strlen(prop_name);
+
+    if (!meta_addr) {
+        wasm_runtime_set_exception(module_inst, "invalid meta address");
+        return false;
+    }
+
+    if (entry->name) {
+        wasm_runtime_free(entry->name);
+    }
+    if (!(entry->name = wasm_runtime_malloc(name_len + 1))) {
+        wasm_runtime_set_exception(module_inst,
+                                   "failed to allocate inline cache");
+        return false;
+    }
+    memcpy(entry->name, prop_name, name_len + 1);
+
+    entry->meta = meta;
+    entry->name_hash = name_hash;
+    entry->flag = flag;
+    entry->flag_and_index =
+        find_meta_property(exec_env, meta_addr, prop_name,
+                           (enum field_flag)flag, &entry->prop_type);
+    return true;
+}
+
+static StructICEntry *
+struct_ic_lookup(wasm_exec_env_t exec_env, int32_t site_id, int32_t meta,
+                 int32_t name, int32_t flag)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    StructICTable *table;
+    StructICSite *site;
+    StructICEntry *entry;
+    const char *prop_name;
+    uint32_t name_hash, i;
+
+    if (!(prop_name = wasm_runtime_addr_app_to_native(module_inst, name))) {
+        wasm_runtime_set_exception(module_inst,
+                                   "invalid property name address");
+        return NULL;
+    }
+    name_hash = hash_field_name(prop_name);
+
+    if (!(table = get_struct_ic_table(wasm_runtime_get_module(module_inst)))
+        || site_id < 0
+        || !(site = get_struct_ic_site(table, (uint32_t)site_id))) {
+        wasm_runtime_set_exception(module_inst,
+                                   "failed to allocate inline cache");
+        return NULL;
+    }
+
+    if (!site->megamorphic) {
+        for (i = 0; i < site->count; i++) {
+            entry = &site->entries[i];
+            if (is_struct_ic_entry_matched(entry, meta, name_hash, prop_name,
+                                           flag)) {
+                return entry;
+            }
+        }
+
+        if (site->count < STRUCT_IC_ENTRIES) {
+            entry = &site->entries[site->count];
+            if (!struct_ic_fill_entry(exec_env, entry, meta, name_hash,
+                                      prop_name, flag)) {
+                return NULL;
+            }
+            site->count++;
+            return entry;
+        }
+
+        site->megamorphic = true;
+    }
+
+    i = ((uint32_t)meta * 31u + name_hash * 7u + (uint32_t)flag)
+        & (STRUCT_IC_MEGA_CACHE_SIZE - 1);
+    entry = &table->mega_cache[i];
+    if (!is_struct_ic_entry_matched(entry, meta, name_hash, prop_name, flag)) {
+        if (!struct_ic_fill_entry(exec_env, entry, meta, name_hash, prop_name,
+                                  flag)) {
+            entry->meta = -1;
+            return NULL;
+        }
+    }
+    return entry;
+}
+
+int
+struct_ic_find_flag_and_index(wasm_exec_env_t exec_env, int site_id,
+                              int meta, int name, int flag)
+{
+    StructICEntry *entry =
+        struct_ic_lookup(exec_env, site_id, meta, name, flag);
+
+    return entry ? entry->flag_and_index : -1;
+}
+
+int
+struct_ic_find_type(wasm_exec_env_t exec_env, int site_id, int meta, int name,
+                    int flag)
+{
+    StructICEntry *entry =
+        struct_ic_lookup(exec_env, site_id, meta, name, flag);
+
+    return entry ? entry->prop_type : -1;
+}
+
+static void
+free_struct_ic_entry_names(StructICEntry *entries, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (entries[i].name) {
+            wasm_runtime_free(entries[i].name);
+        }
+    }
+}
+
+void
+destroy_struct_ic_tables()
+{
+    StructICTable *table, *next;
+    uint32_t i;
+
+    for (table = struct_ic_tables; table; table = next) {
+        next = table->next;
+        if (table->sites) {
+            for (i = 0; i < table->site_count; i++) {
+                free_struct_ic_entry_names(table->sites[i].entries,
+                                           table->sites[i].count);
+            }
+            wasm_runtime_free(table->sites);
+        }
+        free_struct_ic_entry_names(table->mega_cache,
+                                   STRUCT_IC_MEGA_CACHE_SIZE);
+        wasm_runtime_free(table);
+    }
+    struct_ic_tables = NULL;
+}
+
 /* clang-format off */
 #define REG_NATIVE_FUNC(func_name, signature) \
     { #func_name, func_name, signature, NULL }
@@ -231,6 +492,8 @@ static NativeSymbol native_symbols[] = {
     REG_NATIVE_FUNC(struct_set_indirect_f64, "(riF)"),
     REG_NATIVE_FUNC(struct_set_indirect_anyref, "(rir)"),
     REG_NATIVE_FUNC(struct_set_indirect_funcref, "(rir)"),
+    REG_NATIVE_FUNC(struct_ic_find_flag_and_index, "(iiii)i"),
+    REG_NATIVE_FUNC(struct_ic_find_type, "(iiii)i"),
 };
 /* clang-format on */
 
@@ -47,4 +47,19 @@ struct_set_indirect_anyref(wasm_exec_env_t exec_env, wasm_anyref_obj_t obj,
 
 void
 struct_set_indirect_funcref(wasm_exec_env_t exec_env, wasm_anyref_obj_t obj,
-                       int index, void *value);
\ No newline at end of file
+                       int index, void *value);
+
+/* inline cached find_property_flag_and_index/find_property_type of the
+ * interface access site site_id */
+int
+struct_ic_find_flag_and_index(wasm_exec_env_t exec_env, int site_id,
+                              int meta, int name, int flag);
+
+int
+struct_ic_find_type(wasm_exec_env_t exec_env, int site_id, int meta, int name,
+                    int flag);
+
+/* release the inline caches, must be called before the modules are unloaded
+ */
+void
+destroy_struct_ic_tables();
@@ -8,10 +8,10 @@
 #endif
 
 #include "gc_object.h"
+#include "wasm_runtime_common.h"
 #include "libdyntype.h"
 #include "object_utils.h"
 #include "type_utils.h"
-#include "wamr_utils.h"
 #include "libdyntype_export.h"
 #include "dynamic/pure_dynamic.h"
 #include "lib_struct_indirect.h"
@@ -39,6 +39,36 @@ box_ptr_to_anyref(wasm_exec_env_t exec_env, dyn_ctx_t ctx, void *ptr)
     return any_obj;
 }
 
+dyn_value_t
+box_obj_to_extref(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_obj_t obj,
+                  external_ref_tag tag)
+{
+    dyn_value_t ret;
+
+    /* extref holds the object directly, it must stay alive until the extref
+     * is finalized, see extref_object_finalizer */
+    if (!wasm_runtime_pin_object(exec_env, obj)) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "libdyntype: pin extref object failed");
+        return NULL;
+    }
+
+    ret = dyntype_new_extref(ctx, obj, tag, (void *)exec_env);
+    if (!ret) {
+        wasm_runtime_unpin_object(exec_env, obj);
+    }
+
+    return ret;
+}
+
+void
+extref_object_finalizer(void *exec_env, void *ref)
+{
+    if (exec_env) {
+        wasm_runtime_unpin_object((wasm_exec_env_t)exec_env, (wasm_obj_t)ref);
+    }
+}
+
 static uint32
 get_slot_count(wasm_ref_type_t type)
 {
@@ -53,6 +83,108 @@ get_slot_count(wasm_ref_type_t type)
     }
 }
 
+#if WASM_ENABLE_STRINGREF == 0
+/*
+    string conversion cache
+
+    A string boxed to any and unboxed back (or the reverse) would be copied
+    on every crossing. The latest conversions are remembered here, keyed by
+    the identity of the dynamic string: the dynamic string is held and the
+    wasm string is pinned while they are cached, so neither of them can be
+    freed and have its address reused. Wasm strings are never modified in
+    place, so the cached wasm string can be shared.
+*/
+#define STRING_CONV_CACHE_SIZE 16
+
+typedef struct StringConvCacheEntry {
+    const void *str_id;
+    dyn_value_t dyn_str;
+    wasm_obj_t wasm_str;
+} StringConvCacheEntry;
+
+static StringConvCacheEntry string_conv_cache[STRING_CONV_CACHE_SIZE];
+
+#define STRING_CONV_CACHE_SLOT(str_id) \
+    ((((uintptr_t)(str_id)) >> 4) & (STRING_CONV_CACHE_SIZE - 1))
+
+static void
+string_conv_cache_put(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                      dyn_value_t dyn_str, wasm_obj_t wasm_str)
+{
+    const void *str_id = dynamic_get_string_id(ctx, dyn_str);
+    StringConvCacheEntry *entry;
+    dyn_value_t held_str;
+
+    if (!str_id) {
+        return;
+    }
+
+    if (!wasm_runtime_pin_object(exec_env, wasm_str)) {
+        return;
+    }
+    if (!(held_str = dynamic_hold(ctx, dyn_str))) {
+        wasm_runtime_unpin_object(exec_env, wasm_str);
+        return;
+    }
+
+    entry = &string_conv_cache[STRING_CONV_CACHE_SLOT(str_id)];
+    if (entry->str_id) {
+        wasm_runtime_unpin_object(exec_env, entry->wasm_str);
+        dynamic_release(ctx, entry->dyn_str);
+    }
+    entry->str_id = str_id;
+    entry->dyn_str = held_str;
+    entry->wasm_str = wasm_str;
+}
+
+static wasm_obj_t
+string_conv_cache_get_wasm_str(dyn_ctx_t ctx, dyn_value_t dyn_str)
+{
+    const void *str_id = dynamic_get_string_id(ctx, dyn_str);
+    StringConvCacheEntry *entry;
+
+    if (!str_id) {
+        return NULL;
+    }
+
+    entry = &string_conv_cache[STRING_CONV_CACHE_SLOT(str_id)];
+    return entry->str_id == str_id ? entry->wasm_str : NULL;
+}
+
+static dyn_value_t
+string_conv_cache_get_dyn_str(dyn_ctx_t ctx, wasm_obj_t wasm_str)
+{
+    uint32 i;
+
+    for (i = 0; i < STRING_CONV_CACHE_SIZE; i++) {
+        if (string_conv_cache[i].str_id
+            && string_conv_cache[i].wasm_str == wasm_str) {
+            return dynamic_hold(ctx, string_conv_cache[i].dyn_str);
+        }
+    }
+
+    return NULL;
+}
+#endif /* end of WASM_ENABLE_STRINGREF == 0 */
+
+void
+destroy_string_conv_cache()
+{
+#if WASM_ENABLE_STRINGREF == 0
+    dyn_ctx_t ctx = dyntype_get_context();
+    uint32 i;
+
+    /* the wasm strings don't need to be unpinned, they are released with the
+     * module instance */
+    for (i = 0; i < STRING_CONV_CACHE_SIZE; i++) {
+        if (string_conv_cache[i].str_id && ctx) {
+            dynamic_release(ctx, string_conv_cache[i].dyn_str);
+        }
+    }
+    memset(string_conv_cache, 0, sizeof(string_conv_cache));
+#endif
+}
+
 dyn_value_t
 box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
                  wasm_ref_type_t type, bool is_get_property, int index)
@@ -61,7 +193,6 @@ box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
     wasm_defined_type_t ret_defined_type = { 0 };
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     wasm_module_t module = wasm_runtime_get_module(module_inst);
-    wasm_function_inst_t alloc_extref_table_slot = NULL;
 
     if (type.value_type == VALUE_TYPE_I32) {
         /* boolean */
@@ -147,49 +278,40 @@ box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
         }
 
         if (wasm_defined_type_is_struct_type(ret_defined_type)) {
+            const ts_type_info_t *type_info =
+                get_ts_type_info_by_idx(module, (uint32_t)type.heap_type);
+            ts_type_kind_t kind =
+                type_info ? type_info->kind : TS_TYPE_KIND_OTHER;
 #if WASM_ENABLE_STRINGREF == 0
-            if (is_ts_string_type(module, ret_defined_type)) {
-                const char *str = get_str_from_string_struct(ori_value);
-                uint32_t str_len = get_str_length_from_string_struct(ori_value);
+            if (kind == TS_TYPE_KIND_STRING) {
+                ret = string_conv_cache_get_dyn_str(ctx, ori_value);
+                if (!ret) {
+                    const char *str = get_str_from_string_struct(ori_value);
+                    uint32_t str_len =
+                        get_str_length_from_string_struct(ori_value);
 
-                ret = dynamic_new_string(ctx, str, str_len);
+                    ret = dynamic_new_string(ctx, str, str_len);
+                    if (ret) {
+                        string_conv_cache_put(exec_env, ctx, ret, ori_value);
+                    }
+                }
             }
             else {
 #endif
-                wasm_value_t wasm_ret_value = { 0 };
-                uint32_t occupied_slots = 0;
-                uint32_t extref_argv[6] = { 0 };
-                uint32_t extref_agc = 6;
-                int tag = 0;
+                external_ref_tag tag;
 
-                if (is_ts_array_type(module, ret_defined_type)) {
+                if (kind == TS_TYPE_KIND_ARRAY) {
                     tag = ExtArray;
                 }
-                else if (is_ts_closure_type(module, ret_defined_type)) {
+                else if (kind == TS_TYPE_KIND_CLOSURE) {
                     tag = ExtFunc;
                 }
                 else {
                     tag = ExtObj;
                 }
 
-                alloc_extref_table_slot = wasm_runtime_lookup_function(
-                    module_inst, "allocExtRefTableSlot", "(r)i");
-                bh_assert(alloc_extref_table_slot);
-
-                bh_memcpy_s(extref_argv + occupied_slots,
-                            sizeof(wasm_anyref_obj_t), &ori_value,
-                            sizeof(wasm_anyref_obj_t));
-                occupied_slots += sizeof(wasm_anyref_obj_t) / sizeof(uint32);
-                extref_agc = occupied_slots;
-
-                if (!wasm_runtime_call_wasm(exec_env, alloc_extref_table_slot,
-                                            extref_agc, extref_argv)) {
-                    return NULL;
-                }
-                bh_memcpy_s(&wasm_ret_value, sizeof(wasm_anyref_obj_t),
-                            extref_argv, sizeof(wasm_anyref_obj_t));
-                ret = dyntype_new_extref(
-                    ctx, (void *)(uintptr_t)wasm_ret_value.i32, tag, NULL);
+                ret = box_obj_to_extref(exec_env, ctx, (wasm_obj_t)ori_value,
+                                        tag);
 #if WASM_ENABLE_STRINGREF == 0
             }
 #endif
@@ -218,7 +340,37 @@ unbox_string_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj)
     char *value = NULL;
     int ret;
     void *new_string_struct = NULL;
+#if WASM_ENABLE_STRINGREF == 0
+    uint32_t len = 0;
+    char *data;
+
+    if ((new_string_struct = string_conv_cache_get_wasm_str(ctx, obj))) {
+        return new_string_struct;
+    }
 
+    /* a string is encoded from its storage straight into a string array of
+     * the exact length, other values are converted to strings first */
+    if (dynamic_encode_string_utf8(ctx, obj, NULL, &len)) {
+        new_string_struct = alloc_wasm_string(exec_env, len, &data);
+        if (!new_string_struct) {
+            goto end;
+        }
+        dynamic_encode_string_utf8(ctx, obj, data, &len);
+    }
+    else {
+        ret = dynamic_to_cstring_len(ctx, obj, &value, &len);
+        if (ret != DYNTYPE_SUCCESS) {
+            goto end;
+        }
+
+        new_string_struct = create_wasm_string_with_len(exec_env, value, len);
+        if (!new_string_struct) {
+            goto end;
+        }
+    }
+
+    string_conv_cache_put(exec_env, ctx, obj, new_string_struct);
+#else
     ret = dynamic_to_cstring(ctx, obj, &value);
     if (ret != DYNTYPE_SUCCESS) {
         goto end;
@@ -228,6 +380,7 @@ unbox_string_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj)
     if (!new_string_struct) {
         goto end;
     }
+#endif
 
 end:
     if (value) {
@@ -237,7 +390,7 @@ end:
     return new_string_struct;
 }
 
-void
+bool
 unbox_value_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
                      wasm_ref_type_t type, wasm_value_t *unboxed_value,
                      bool is_set_property, int index)
@@ -306,7 +459,10 @@ unbox_value_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
         ret_defined_type = wasm_get_defined_type(module, type.heap_type);
         if (wasm_defined_type_is_struct_type(ret_defined_type)) {
 #if WASM_ENABLE_STRINGREF == 0
-            if (is_ts_string_type(module, ret_defined_type)) {
+            const ts_type_info_t *type_info =
+                get_ts_type_info_by_idx(module, (uint32_t)type.heap_type);
+
+            if (type_info && type_info->kind == TS_TYPE_KIND_STRING) {
                 void *ret_value = unbox_string_from_any(exec_env, ctx, obj);
                 if (is_set_property) {
                     struct_set_indirect_anyref(
@@ -320,16 +476,11 @@ unbox_value_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
             else {
 #endif
                 void *ret_value;
-                uint32_t table_idx;
-                void *p_table_index;
-                int32_t tag = dynamic_to_extref(ctx, obj, &p_table_index);
+                int32_t tag = dynamic_to_extref(ctx, obj, &ret_value);
 
                 if (tag == -DYNTYPE_TYPEERR) {
                     goto fail;
                 }
-                table_idx = (uint32_t)(uintptr_t)p_table_index;
-
-                ret_value = wamr_utils_get_table_element(exec_env, table_idx);
                 if (is_set_property) {
                     struct_set_indirect_anyref(
                         exec_env, (wasm_anyref_obj_t)unboxed_value->gc_obj,
@@ -344,104 +495,263 @@ unbox_value_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
         }
     }
 
-    return;
+    return true;
 
 fail:
     wasm_runtime_set_exception(module_inst, "failed to unbox value from any");
+    return false;
 }
 
-dyn_value_t
-call_wasm_func_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
-                           wasm_anyref_obj_t func_any_obj, uint32_t argc,
-                           dyn_value_t *func_args)
+/* returns false and leaves the exception in the module instance if obj
+ * can't be unboxed to the param type */
+typedef bool (*param_unboxer_t)(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                                dyn_value_t obj, wasm_ref_type_t type,
+                                wasm_value_t *unboxed_value);
+
+typedef struct WasmParamDesc {
+    wasm_ref_type_t type;
+    param_unboxer_t unbox;
+    uint32_t slot_count;
+    /* the unboxed value is a gc object which must be rooted until all the
+     * arguments are unboxed */
+    bool is_ref;
+} WasmParamDesc;
+
+/* Calling convention of a wasm func type, computed once and shared by all the
+ * calls from the dynamic world into functions of this type */
+typedef struct WasmFuncCallDesc {
+    struct WasmFuncCallDesc *next;
+    wasm_func_type_t func_type;
+    uint32_t param_count;
+    uint32_t result_count;
+    /* slots required by argv, it also holds the result */
+    uint32_t argv_slots;
+    wasm_ref_type_t result_type;
+    /* params after the env params (context and thiz) */
+    WasmParamDesc params[1];
+} WasmFuncCallDesc;
+
+#define FUNC_CALL_DESC_BUCKETS 64
+#define CALL_ARGV_STACK_SLOTS 32
+#define CALL_LOCAL_REFS_STACK_COUNT 16
+
+static WasmFuncCallDesc *func_call_desc_cache[FUNC_CALL_DESC_BUCKETS];
+
+static bool
+unbox_bool_param(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
+                 wasm_ref_type_t type, wasm_value_t *unboxed_value)
 {
-    int i;
+    bool value;
+
+    if (dynamic_to_bool(ctx, obj, &value) != DYNTYPE_SUCCESS) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "failed to unbox value from any");
+        return false;
+    }
+    unboxed_value->i32 = value;
+    return true;
+}
+
+static bool
+unbox_number_param(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
+                   wasm_ref_type_t type, wasm_value_t *unboxed_value)
+{
+    double value;
+
+    if (dyntype_to_number(ctx, obj, &value) != DYNTYPE_SUCCESS) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "failed to unbox value from any");
+        return false;
+    }
+    unboxed_value->f64 = value;
+    return true;
+}
+
+static bool
+unbox_any_param(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
+                wasm_ref_type_t type, wasm_value_t *unboxed_value)
+{
+    unboxed_value->gc_obj =
+        (wasm_obj_t)box_ptr_to_anyref(exec_env, ctx, dyntype_hold(ctx, obj));
+    return unboxed_value->gc_obj != NULL;
+}
+
+static bool
+unbox_generic_param(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
+                    wasm_ref_type_t type, wasm_value_t *unboxed_value)
+{
+    return unbox_value_from_any(exec_env, ctx, obj, type, unboxed_value, false,
+                                -1);
+}
+
+static WasmFuncCallDesc *
+get_func_call_desc(wasm_func_type_t func_type)
+{
+    WasmFuncCallDesc *desc;
+    WasmParamDesc *param;
+    uint32_t bucket, i, param_count, result_count, param_slots, result_slots;
+    uint64 total_size;
+
+    bucket = (uint32_t)(((uintptr_t)func_type >> 3) % FUNC_CALL_DESC_BUCKETS);
+    for (desc = func_call_desc_cache[bucket]; desc; desc = desc->next) {
+        if (desc->func_type == func_type) {
+            return desc;
+        }
+    }
+
+    param_count = wasm_func_type_get_param_count(func_type);
+    result_count = wasm_func_type_get_result_count(func_type);
+    if (param_count < ENV_PARAM_LEN) {
+        return NULL;
+    }
+
+    total_size = offsetof(WasmFuncCallDesc, params)
+                 + sizeof(WasmParamDesc) * (param_count - ENV_PARAM_LEN + 1);
+    if (!(desc = wasm_runtime_malloc((uint32_t)total_size))) {
+        return NULL;
+    }
+    memset(desc, 0, (uint32_t)total_size);
+
+    desc->func_type = func_type;
+    desc->param_count = param_count;
+    desc->result_count = result_count;
+
+    /* context and thiz */
+    param_slots = ENV_PARAM_LEN * sizeof(void *) / sizeof(uint32);
+    for (i = 0; i < param_count - ENV_PARAM_LEN; i++) {
+        param = &desc->params[i];
+        param->type =
+            wasm_func_type_get_param_type(func_type, i + ENV_PARAM_LEN);
+        param->slot_count = get_slot_count(param->type);
+        param_slots += param->slot_count;
+
+        if (param->type.value_type == VALUE_TYPE_I32) {
+            param->unbox = unbox_bool_param;
+        }
+        else if (param->type.value_type == VALUE_TYPE_F64) {
+            param->unbox = unbox_number_param;
+        }
+        else if (param->type.value_type == REF_TYPE_ANYREF) {
+            param->unbox = unbox_any_param;
+            param->is_ref = true;
+        }
+        else {
+            param->unbox = unbox_generic_param;
+            param->is_ref = true;
+        }
+    }
+
+    result_slots = 0;
+    if (result_count > 0) {
+        desc->result_type = wasm_func_type_get_result_type(func_type, 0);
+        result_slots = get_slot_count(desc->result_type);
+    }
+    desc->argv_slots = param_slots > result_slots ? param_slots : result_slots;
+
+    desc->next = func_call_desc_cache[bucket];
+    func_call_desc_cache[bucket] = desc;
+    return desc;
+}
+
+void
+destroy_func_call_desc_cache()
+{
+    WasmFuncCallDesc *desc, *next;
+    uint32_t i;
+
+    for (i = 0; i < FUNC_CALL_DESC_BUCKETS; i++) {
+        desc = func_call_desc_cache[i];
+        while (desc) {
+            next = desc->next;
+            wasm_runtime_free(desc);
+            desc = next;
+        }
+        func_call_desc_cache[i] = NULL;
+    }
+}
+
+static dyn_value_t
+throw_call_error(wasm_exec_env_t exec_env, dyn_ctx_t ctx, const char *exception)
+{
+#if WASM_ENABLE_STRINGREF != 0
+    return dyntype_throw_exception(
+        ctx, dyntype_new_string(ctx,
+                                wasm_stringref_obj_get_value(
+                                    create_wasm_string(exec_env, exception))));
+#else
+    return dyntype_throw_exception(
+        ctx, dyntype_new_string(ctx, exception, strlen(exception)));
+#endif
+}
+
+static dyn_value_t
+call_func_ref_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                          wasm_func_obj_t func_ref, wasm_value_t context,
+                          wasm_value_t thiz, uint32_t argc,
+                          dyn_value_t *func_args)
+{
+    uint32_t i;
     dyn_value_t ret = NULL;
-    wasm_func_obj_t func_ref = { 0 };
-    wasm_func_type_t func_type = { 0 };
-    wasm_ref_type_t result_type = { 0 };
-    wasm_ref_type_t tmp_param_type = { 0 };
-    wasm_struct_obj_t closure_obj = { 0 };
+    WasmFuncCallDesc *desc;
+    WasmParamDesc *param;
     wasm_value_t tmp_result;
     wasm_value_t tmp_param;
-    wasm_local_obj_ref_t *local_refs = NULL;
-    uint32_t slot_count = 0, local_ref_count = 0;
+    wasm_local_obj_ref_t local_refs_buf[CALL_LOCAL_REFS_STACK_COUNT];
+    wasm_local_obj_ref_t *local_refs = local_refs_buf;
+    uint32_t local_ref_count = 0;
     uint32_t occupied_slots = 0;
-    uint32_t *argv = NULL;
+    uint32_t argv_buf[CALL_ARGV_STACK_SLOTS];
+    uint32_t *argv = argv_buf;
     uint32_t bsize = 0;
-    uint32_t result_count = 0;
-    uint32_t param_count = 0;
     bool is_success;
 
-    closure_obj = (wasm_struct_obj_t)func_any_obj;
-    GET_ELEM_FROM_CLOSURE(closure_obj);
-    func_ref = (wasm_func_obj_t)(func_obj.gc_obj);
-    func_type = wasm_func_obj_get_func_type(func_ref);
-    result_count = wasm_func_type_get_result_count(func_type);
-    param_count = wasm_func_type_get_param_count(func_type);
+    desc = get_func_call_desc(wasm_func_obj_get_func_type(func_ref));
+    if (!desc) {
+        return throw_call_error(exec_env, ctx,
+                                "libdyntype: alloc memory failed");
+    }
 
-    if (param_count != argc + ENV_PARAM_LEN) {
-        const char *exception =
-            "libdyntype: function param count not equal with the real param";
-#if WASM_ENABLE_STRINGREF != 0
-        return dyntype_throw_exception(
-            ctx, dyntype_new_string(
-                     ctx, wasm_stringref_obj_get_value(
-                              create_wasm_string(exec_env, exception))));
-#else
-        return dyntype_throw_exception(
-            ctx, dyntype_new_string(ctx, exception, strlen(exception)));
-#endif
+    if (desc->param_count != argc + ENV_PARAM_LEN) {
+        return throw_call_error(
+            exec_env, ctx,
+            "libdyntype: function param count not equal with the real param");
     }
 
-    bsize = sizeof(uint64) * (param_count);
-    argv = wasm_runtime_malloc(bsize);
-    if (!argv) {
-        const char *exception = "libdyntype: alloc memory failed";
-#if WASM_ENABLE_STRINGREF != 0
-        return dyntype_throw_exception(
-            ctx, dyntype_new_string(
-                     ctx, wasm_stringref_obj_get_value(
-                              create_wasm_string(exec_env, exception))));
-#else
-        return dyntype_throw_exception(
-            ctx, dyntype_new_string(ctx, exception, strlen(exception)));
-#endif
+    bsize = sizeof(uint32) * desc->argv_slots;
+    if (desc->argv_slots > CALL_ARGV_STACK_SLOTS
+        && !(argv = wasm_runtime_malloc(bsize))) {
+        return throw_call_error(exec_env, ctx,
+                                "libdyntype: alloc memory failed");
     }
 
     /* reserve space for context and thiz */
     POPULATE_ENV_ARGS(argv, bsize, occupied_slots, context, thiz);
 
-    if (argc > 0
+    if (argc > CALL_LOCAL_REFS_STACK_COUNT
         && !(local_refs =
                  wasm_runtime_malloc(sizeof(wasm_local_obj_ref_t) * argc))) {
-        const char *exception = "libdyntype: alloc memory failed";
-#if WASM_ENABLE_STRINGREF != 0
-        ret = dyntype_throw_exception(
-            ctx, dyntype_new_string(
-                     ctx, wasm_stringref_obj_get_value(
-                              create_wasm_string(exec_env, exception))));
-#else
-        ret = dyntype_throw_exception(
-            ctx, dyntype_new_string(ctx, exception, strlen(exception)));
-#endif
+        ret = throw_call_error(exec_env, ctx,
+                               "libdyntype: alloc memory failed");
         goto end;
     }
 
     for (i = 0; i < argc; i++) {
-        tmp_param_type =
-            wasm_func_type_get_param_type(func_type, i + ENV_PARAM_LEN);
-        slot_count = get_slot_count(tmp_param_type);
-        unbox_value_from_any(exec_env, ctx, func_args[i], tmp_param_type,
-                             &tmp_param, false, -1);
+        param = &desc->params[i];
+        /* params not written by the unboxer are passed as 0 or null */
+        memset(&tmp_param, 0, sizeof(tmp_param));
+        if (!param->unbox(exec_env, ctx, func_args[i], param->type,
+                          &tmp_param)) {
+            if (local_ref_count) {
+                wasm_runtime_pop_local_object_refs(exec_env, local_ref_count);
+            }
+            ret = throw_call_error(
+                exec_env, ctx, "libdyntype: failed to unbox value from any");
+            goto end;
+        }
 
-        if (tmp_param_type.value_type == VALUE_TYPE_ANYREF
-#if WASM_ENABLE_STRINGREF != 0
-            || tmp_param_type.value_type == VALUE_TYPE_STRINGREF
-#endif
-        ) {
-            /* unbox_value_from_any will create anyref for any-objects, we must
-             * hold its reference to avoid it being claimed */
+        if (param->is_ref) {
+            /* unboxing may create new objects (e.g. anyref for any-objects),
+             * we must hold its reference to avoid it being claimed */
             wasm_runtime_push_local_object_ref(exec_env,
                                                &local_refs[local_ref_count]);
             local_refs[local_ref_count++].val = tmp_param.gc_obj;
@@ -449,8 +759,8 @@ call_wasm_func_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
 
         bh_memcpy_s(argv + occupied_slots,
                     bsize - occupied_slots * sizeof(uint32), &tmp_param,
-                    slot_count * sizeof(uint32));
-        occupied_slots += slot_count;
+                    param->slot_count * sizeof(uint32));
+        occupied_slots += param->slot_count;
     }
 
     if (local_ref_count) {
@@ -469,24 +779,472 @@ call_wasm_func_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
         goto end;
     }
 
-    if (result_count > 0) {
-        result_type = wasm_func_type_get_result_type(func_type, 0);
-        slot_count = get_slot_count(result_type);
+    if (desc->result_count > 0) {
+        uint32_t slot_count = get_slot_count(desc->result_type);
         bh_memcpy_s(&tmp_result, slot_count * sizeof(uint32), argv,
                     slot_count * sizeof(uint32));
-        ret = box_value_to_any(exec_env, ctx, &tmp_result, result_type, false,
-                               -1);
+        ret = box_value_to_any(exec_env, ctx, &tmp_result, desc->result_type,
+                               false, -1);
     }
     else {
         ret = dynamic_new_undefined(ctx);
     }
 
 end:
-    if (local_refs) {
+    if (local_refs != local_refs_buf) {
         wasm_runtime_free(local_refs);
     }
 
-    wasm_runtime_free(argv);
+    if (argv != argv_buf) {
+        wasm_runtime_free(argv);
+    }
 
     return ret;
 }
+
+dyn_value_t
+call_wasm_func_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                           wasm_anyref_obj_t func_any_obj, uint32_t argc,
+                           dyn_value_t *func_args)
+{
+    wasm_struct_obj_t closure_obj = (wasm_struct_obj_t)func_any_obj;
+
+    GET_ELEM_FROM_CLOSURE(closure_obj);
+    return call_func_ref_with_boxing(exec_env, ctx,
+                                     (wasm_func_obj_t)func_obj.gc_obj, context,
+                                     thiz, argc, func_args);
+}
+
+dyn_value_t
+call_wasm_method_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                             wasm_func_obj_t method, wasm_obj_t thiz_obj,
+                             uint32_t argc, dyn_value_t *func_args)
+{
+    /* same env args as the closure created by box_value_to_any for a method:
+     * empty context and the object itself as thiz */
+    wasm_value_t context = { 0 }, thiz = { .gc_obj = thiz_obj };
+
+    return call_func_ref_with_boxing(exec_env, ctx, method, context, thiz,
+                                     argc, func_args);
+}
+
+/*
+    typed call from the host
+
+    The signature of the callee is resolved once into a call handle, so a
+    call only copies the ts values into the argument slots, no dynamic value
+    is created and the wasm types are not inspected again.
+*/
+typedef enum TSCallSlotKind {
+    TS_CALL_SLOT_I32 = 0,
+    TS_CALL_SLOT_F64,
+    TS_CALL_SLOT_REF,
+} TSCallSlotKind;
+
+typedef struct TSCallParamDesc {
+    TSCallSlotKind kind;
+    uint32_t slot_count;
+    /* ts type accepted by a reference slot */
+    ts_value_type_t ts_type;
+    /* defined type of a reference slot, NULL for abstract and string refs */
+    wasm_defined_type_t defined_type;
+} TSCallParamDesc;
+
+struct ts_call_handle_t {
+    wasm_module_t module;
+    /* exported function, NULL if the handle is created from a closure */
+    wasm_function_inst_t func;
+    /* closure and its elements, the closure is pinned while the handle is
+     * alive */
+    wasm_obj_t closure;
+    wasm_func_obj_t func_ref;
+    wasm_value_t context;
+    wasm_value_t thiz;
+    /* number of env params (context and thiz), 0 for exported functions */
+    uint32_t env_param_count;
+    uint32_t param_count;
+    uint32_t argv_slots;
+    bool has_result;
+    TSCallParamDesc result;
+    ts_value_type_t result_ts_type;
+    TSCallParamDesc params[1];
+};
+
+static TSCallSlotKind
+get_call_slot_kind(wasm_ref_type_t type)
+{
+    if (type.value_type == VALUE_TYPE_I32) {
+        return TS_CALL_SLOT_I32;
+    }
+    else if (type.value_type == VALUE_TYPE_F64) {
+        return TS_CALL_SLOT_F64;
+    }
+    return TS_CALL_SLOT_REF;
+}
+
+static ts_value_type_t
+get_slot_ts_type(wasm_module_t module, wasm_ref_type_t type)
+{
+    const ts_type_info_t *info;
+
+    if (type.value_type == VALUE_TYPE_I32) {
+        return TS_BOOLEAN;
+    }
+    else if (type.value_type == VALUE_TYPE_F64) {
+        return TS_NUMBER;
+    }
+    else if (type.value_type == REF_TYPE_ANYREF) {
+        return TS_ANY;
+    }
+#if WASM_ENABLE_STRINGREF != 0
+    else if (type.value_type == REF_TYPE_STRINGREF) {
+        return TS_STRING;
+    }
+#endif
+    else if (type.heap_type < 0) {
+        return TS_OBJECT;
+    }
+
+    info = get_ts_type_info_by_idx(module, (uint32_t)type.heap_type);
+    if (!info) {
+        return TS_OBJECT;
+    }
+
+    switch (info->kind) {
+        case TS_TYPE_KIND_STRING:
+            return TS_STRING;
+        case TS_TYPE_KIND_CLOSURE:
+            return TS_FUNCTION;
+        case TS_TYPE_KIND_ARRAY:
+            return TS_ARRAY;
+        default:
+            return TS_OBJECT;
+    }
+}
+
+static ts_call_handle_t *
+create_call_handle(wasm_exec_env_t exec_env, wasm_func_type_t func_type,
+                   uint32_t env_param_count)
+{
+    wasm_module_t module =
+        wasm_runtime_get_module(wasm_runtime_get_module_inst(exec_env));
+    ts_call_handle_t *handle;
+    TSCallParamDesc *param;
+    wasm_ref_type_t type;
+    uint32_t i, param_count, param_slots;
+    uint64 total_size;
+
+    param_count = wasm_func_type_get_param_count(func_type);
+    if (param_count < env_param_count
+        || wasm_func_type_get_result_count(func_type) > 1) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "unsupported function signature");
+        return NULL;
+    }
+    param_count -= env_param_count;
+
+    total_size = offsetof(ts_call_handle_t, params)
+                 + sizeof(TSCallParamDesc) * (param_count + 1);
+    if (!(handle = wasm_runtime_malloc((uint32_t)total_size))) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "alloc memory failed");
+        return NULL;
+    }
+    memset(handle, 0, (uint32_t)total_size);
+
+    handle->module = module;
+    handle->env_param_count = env_param_count;
+    handle->param_count = param_count;
+
+    param_slots = env_param_count * sizeof(void *) / sizeof(uint32);
+    for (i = 0; i < param_count; i++) {
+        param = &handle->params[i];
+        type = wasm_func_type_get_param_type(func_type, i + env_param_count);
+        param->kind = get_call_slot_kind(type);
+        param->slot_count = get_slot_count(type);
+        if (param->kind == TS_CALL_SLOT_REF) {
+            param->ts_type = get_slot_ts_type(module, type);
+            if (type.heap_type >= 0) {
+                param->defined_type =
+                    wasm_get_defined_type(module, type.heap_type);
+            }
+        }
+        param_slots += param->slot_count;
+    }
+
+    handle->result_ts_type = TS_NULL;
+    if (wasm_func_type_get_result_count(func_type) > 0) {
+        type = wasm_func_type_get_result_type(func_type, 0);
+        handle->has_result = true;
+        handle->result.kind = get_call_slot_kind(type);
+        handle->result.slot_count = get_slot_count(type);
+        handle->result_ts_type = get_slot_ts_type(module, type);
+    }
+
+    handle->argv_slots = param_slots > handle->result.slot_count
+                             ? param_slots
+                             : handle->result.slot_count;
+    return handle;
+}
+
+ts_call_handle_t *
+ts_call_handle_new(wasm_exec_env_t exec_env, const char *func_name)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    wasm_function_inst_t func;
+    wasm_func_type_t func_type;
+    ts_call_handle_t *handle;
+
+    func = wasm_runtime_lookup_function(module_inst, func_name, NULL);
+    if (!func) {
+        wasm_runtime_set_exception(module_inst, "function not found");
+        return NULL;
+    }
+
+    /* exported functions are the wrappers generated for the entry scope,
+     * they don't take the env params */
+    func_type = (wasm_func_type_t)wasm_runtime_get_function_type(
+        func, ((WASMModuleInstanceCommon *)module_inst)->module_type);
+    if (!(handle = create_call_handle(exec_env, func_type, 0))) {
+        return NULL;
+    }
+
+    handle->func = func;
+    return handle;
+}
+
+ts_call_handle_t *
+ts_call_handle_from_closure(wasm_exec_env_t exec_env, wasm_obj_t closure)
+{
+    wasm_struct_obj_t closure_obj = (wasm_struct_obj_t)closure;
+    ts_call_handle_t *handle;
+
+    GET_ELEM_FROM_CLOSURE(closure_obj);
+    handle = create_call_handle(
+        exec_env, wasm_func_obj_get_func_type((wasm_func_obj_t)func_obj.gc_obj),
+        ENV_PARAM_LEN);
+    if (!handle) {
+        return NULL;
+    }
+
+    if (!wasm_runtime_pin_object(exec_env, closure)) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "pin closure failed");
+        wasm_runtime_free(handle);
+        return NULL;
+    }
+
+    handle->closure = closure;
+    handle->func_ref = (wasm_func_obj_t)func_obj.gc_obj;
+    handle->context = context;
+    handle->thiz = thiz;
+    return handle;
+}
+
+void
+ts_call_handle_free(wasm_exec_env_t exec_env, ts_call_handle_t *handle)
+{
+    if (!handle) {
+        return;
+    }
+
+    if (handle->closure) {
+        wasm_runtime_unpin_object(exec_env, handle->closure);
+    }
+    wasm_runtime_free(handle);
+}
+
+uint32_t
+ts_call_handle_get_param_count(const ts_call_handle_t *handle)
+{
+    return handle->param_count;
+}
+
+static bool
+is_ts_primitive_type(ts_value_type_t type)
+{
+    return type == TS_INT || type == TS_NUMBER || type == TS_BOOLEAN;
+}
+
+/* check the ts value can be passed in the slot of the param, the args are
+ * copied into the slots without conversion, so a value of another kind would
+ * be reinterpreted by the callee */
+static bool
+check_call_arg(const ts_call_handle_t *handle, const TSCallParamDesc *param,
+               const ts_value_t *arg)
+{
+    if (param->kind != TS_CALL_SLOT_REF) {
+        return is_ts_primitive_type(arg->type);
+    }
+
+    if (arg->type == TS_NULL) {
+        return true;
+    }
+
+    if (is_ts_primitive_type(arg->type) || !arg->of.ref) {
+        return false;
+    }
+
+    /* anyref params hold boxed dynamic values only */
+    if (param->ts_type == TS_ANY || arg->type == TS_ANY) {
+        return param->ts_type == arg->type;
+    }
+
+    if (param->defined_type) {
+        return wasm_obj_is_instance_of_defined_type(
+            (wasm_obj_t)arg->of.ref, param->defined_type, handle->module);
+    }
+
+    return param->ts_type == TS_OBJECT || param->ts_type == arg->type;
+}
+
+bool
+ts_call(wasm_exec_env_t exec_env, const ts_call_handle_t *handle,
+        uint32_t argc, const ts_value_t *args, ts_value_t *result)
+{
+    const TSCallParamDesc *param;
+    const ts_value_t *arg;
+    wasm_value_t tmp_param;
+    uint32_t argv_buf[CALL_ARGV_STACK_SLOTS];
+    uint32_t *argv = argv_buf;
+    uint32_t occupied_slots = 0;
+    uint32_t bsize, i;
+    bool is_success;
+
+    if (argc != handle->param_count) {
+        wasm_runtime_set_exception(
+            wasm_runtime_get_module_inst(exec_env),
+            "function param count not equal with the real param");
+        return false;
+    }
+
+    for (i = 0; i < argc; i++) {
+        if (!check_call_arg(handle, &handle->params[i], &args[i])) {
+            wasm_runtime_set_exception(
+                wasm_runtime_get_module_inst(exec_env),
+                "function param type not equal with the real param");
+            return false;
+        }
+    }
+
+    bsize = sizeof(uint32) * handle->argv_slots;
+    if (handle->argv_slots > CALL_ARGV_STACK_SLOTS
+        && !(argv = wasm_runtime_malloc(bsize))) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "alloc memory failed");
+        return false;
+    }
+
+    if (handle->env_param_count) {
+        POPULATE_ENV_ARGS(argv, bsize, occupied_slots, handle->context,
+                          handle->thiz);
+    }
+
+    /* no object is created until the call, so the references in args don't
+     * need to be rooted here */
+    for (i = 0; i < argc; i++) {
+        param = &handle->params[i];
+        arg = &args[i];
+        memset(&tmp_param, 0, sizeof(tmp_param));
+
+        switch (param->kind) {
+            case TS_CALL_SLOT_I32:
+                tmp_param.i32 = arg->type == TS_NUMBER ? (int32_t)arg->of.f64
+                                                       : arg->of.i32;
+                break;
+            case TS_CALL_SLOT_F64:
+                tmp_param.f64 =
+                    (arg->type == TS_INT || arg->type == TS_BOOLEAN)
+                        ? (double)arg->of.i32
+                        : arg->of.f64;
+                break;
+            default:
+                tmp_param.gc_obj =
+                    arg->type == TS_NULL ? NULL : (wasm_obj_t)arg->of.ref;
+                break;
+        }
+
+        bh_memcpy_s(argv + occupied_slots,
+                    bsize - occupied_slots * sizeof(uint32), &tmp_param,
+                    param->slot_count * sizeof(uint32));
+        occupied_slots += param->slot_count;
+    }
+
+    if (handle->func) {
+        is_success =
+            wasm_runtime_call_wasm(exec_env, handle->func, occupied_slots, argv);
+    }
+    else {
+        is_success = wasm_runtime_call_func_ref(exec_env, handle->func_ref,
+                                                occupied_slots, argv);
+    }
+
+    if (is_success && result) {
+        memset(result, 0, sizeof(ts_value_t));
+        result->type = handle->result_ts_type;
+        if (handle->has_result) {
+            bh_memcpy_s(&tmp_param, sizeof(tmp_param), argv,
+                        handle->result.slot_count * sizeof(uint32));
+            if (handle->result.kind == TS_CALL_SLOT_I32) {
+                result->of.i32 = tmp_param.i32;
+            }
+            else if (handle->result.kind == TS_CALL_SLOT_F64) {
+                result->of.f64 = tmp_param.f64;
+            }
+            else {
+                result->of.ref = tmp_param.gc_obj;
+                if (!tmp_param.gc_obj) {
+                    result->type = TS_NULL;
+                }
+            }
+        }
+    }
+
+    if (argv != argv_buf) {
+        wasm_runtime_free(argv);
+    }
+
+    return is_success;
+}
+
+bool
+ts_value_new_string(wasm_exec_env_t exec_env, const char *str, uint32_t len,
+                    ts_value_t *value)
+{
+    wasm_obj_t str_obj =
+        (wasm_obj_t)create_wasm_string_with_len(exec_env, str, len);
+
+    if (!str_obj) {
+        return false;
+    }
+
+    if (!wasm_runtime_pin_object(exec_env, str_obj)) {
+        wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                                   "pin string failed");
+        return false;
+    }
+
+    value->type = TS_STRING;
+    value->of.ref = str_obj;
+    return true;
+}
+
+bool
+ts_value_hold(wasm_exec_env_t exec_env, const ts_value_t *value)
+{
+    if (is_ts_primitive_type(value->type) || !value->of.ref) {
+        return true;
+    }
+
+    return wasm_runtime_pin_object(exec_env, (wasm_obj_t)value->of.ref);
+}
+
+void
+ts_value_release(wasm_exec_env_t exec_env, const ts_value_t *value)
+{
+    if (is_ts_primitive_type(value->type) || !value->of.ref) {
+        return;
+    }
+
+    wasm_runtime_unpin_object(exec_env, (wasm_obj_t)value->of.ref);
+}
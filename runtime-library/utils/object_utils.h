@@ -8,15 +8,27 @@
 
 #include "gc_export.h"
 #include "libdyntype.h"
+#include "type_utils.h"
 
 wasm_anyref_obj_t
 box_ptr_to_anyref(wasm_exec_env_t exec_env, dyn_ctx_t ctx, void *ptr);
 
+/* box a wasm object to extref, the object is pinned until the extref is
+ * finalized */
+dyn_value_t
+box_obj_to_extref(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_obj_t obj,
+                  external_ref_tag tag);
+
+void
+extref_object_finalizer(void *exec_env, void *ref);
+
 dyn_value_t
 box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
                  wasm_ref_type_t type, bool is_get_property, int index);
 
-void
+/* returns false and leaves the exception in the module instance if obj can't
+ * be unboxed to type */
+bool
 unbox_value_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, void *obj,
                      wasm_ref_type_t type, wasm_value_t *unboxed_value,
                      bool is_set_property, int index);
@@ -26,9 +38,78 @@ call_wasm_func_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
                            wasm_anyref_obj_t func_any_obj, uint32_t argc,
                            dyn_value_t *func_args);
 
+/* release the call descriptors cached for the wasm func types, must be called
+ * before the module is unloaded */
+void
+destroy_func_call_desc_cache();
+
+/* call a method of a static object with its vtable funcref directly, without
+ * creating a closure for it */
+dyn_value_t
+call_wasm_method_with_boxing(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                             wasm_func_obj_t method, wasm_obj_t thiz_obj,
+                             uint32_t argc, dyn_value_t *func_args);
+
+/* unbox a string from any, the contents are copied into the wasm string
+ * once, and recently converted strings are reused */
+#if WASM_ENABLE_STRINGREF != 0
+wasm_stringref_obj_t
+#else
+wasm_struct_obj_t
+#endif
+unbox_string_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                      dyn_value_t obj);
+
+/* release the string conversion cache, must be called before the dynamic
+ * context is destroyed */
+void
+destroy_string_conv_cache();
+
 #if WASM_ENABLE_STRINGREF != 0
 bool
 string_compare(wasm_stringref_obj_t lhs, wasm_stringref_obj_t rhs);
 #endif
 
+/* typed call from the host, the signature of the callee is resolved once when
+ * the handle is created, args and result are passed as ts values without
+ * boxing them to any */
+typedef struct ts_call_handle_t ts_call_handle_t;
+
+/* create a call handle for an exported function */
+ts_call_handle_t *
+ts_call_handle_new(wasm_exec_env_t exec_env, const char *func_name);
+
+/* create a call handle for a closure, the closure is pinned until the handle
+ * is freed */
+ts_call_handle_t *
+ts_call_handle_from_closure(wasm_exec_env_t exec_env, wasm_obj_t closure);
+
+void
+ts_call_handle_free(wasm_exec_env_t exec_env, ts_call_handle_t *handle);
+
+uint32_t
+ts_call_handle_get_param_count(const ts_call_handle_t *handle);
+
+/* call the function of the handle, returns false and leaves the exception in
+ * the module instance if the call failed.
+ * i32 results are returned as TS_BOOLEAN, references in args must stay alive
+ * during the call and a reference result is not rooted, hold it with
+ * ts_value_hold if it's used after another call */
+bool
+ts_call(wasm_exec_env_t exec_env, const ts_call_handle_t *handle,
+        uint32_t argc, const ts_value_t *args, ts_value_t *result);
+
+/* create a wasm string from the first len bytes of str, the string is held
+ * until ts_value_release is called */
+bool
+ts_value_new_string(wasm_exec_env_t exec_env, const char *str, uint32_t len,
+                    ts_value_t *value);
+
+/* keep the referenced object of a ts value alive across calls */
+bool
+ts_value_hold(wasm_exec_env_t exec_env, const ts_value_t *value);
+
+void
+ts_value_release(wasm_exec_env_t exec_env, const ts_value_t *value);
+
 #endif /* end of __OBJECT_UTILS_H_ */
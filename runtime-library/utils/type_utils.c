@@ -11,7 +11,6 @@
 #include "gc_export.h"
 #include "gc_object.h"
 #include "libdyntype.h"
-#include "wamr_utils.h"
 #include "libdyntype_export.h"
 #include "quickjs.h"
 
@@ -30,6 +29,32 @@
 /** start type id of custom type */
 #define CUSTOM_TYPE_BEGIN 1052
 
+/* get the defined type referenced by a field, NULL if the field isn't a
+ * reference to a defined type */
+static wasm_defined_type_t
+get_field_defined_type(wasm_module_t wasm_module, wasm_ref_type_t field_type)
+{
+    switch (field_type.value_type) {
+        case VALUE_TYPE_I32:
+        case VALUE_TYPE_I64:
+        case VALUE_TYPE_F32:
+        case VALUE_TYPE_F64:
+        case VALUE_TYPE_I8:
+        case VALUE_TYPE_I16:
+            return NULL;
+        default:
+            break;
+    }
+
+    if (field_type.heap_type < 0
+        || (uint32_t)field_type.heap_type
+               >= wasm_get_defined_type_count(wasm_module)) {
+        return NULL;
+    }
+
+    return wasm_get_defined_type(wasm_module, field_type.heap_type);
+}
+
 /*
     utilities for closure object
 
@@ -42,15 +67,14 @@
     |  2:func  |      |            func           |
     +----------+      +---------------------------+
 */
-bool
-is_ts_closure_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+static bool
+check_ts_closure_type(wasm_module_t wasm_module, wasm_defined_type_t type)
 {
     bool is_struct_type;
     wasm_struct_type_t struct_type;
     uint32_t field_count;
     bool mut;
     wasm_ref_type_t field_type;
-    uint32_t field_type_idx = 0;
     wasm_defined_type_t field_defined_type;
 
     is_struct_type = wasm_defined_type_is_struct_type(type);
@@ -66,21 +90,21 @@ is_ts_closure_type(wasm_module_t wasm_module, wasm_defined_type_t type)
     }
     field_type =
         wasm_struct_type_get_field_type(struct_type, CONTEXT_INDEX, &mut);
-    field_type_idx = field_type.heap_type;
-    field_defined_type = wasm_get_defined_type(wasm_module, field_type_idx);
-    if (!wasm_defined_type_is_struct_type(field_defined_type)) {
+    field_defined_type = get_field_defined_type(wasm_module, field_type);
+    if (!field_defined_type
+        || !wasm_defined_type_is_struct_type(field_defined_type)) {
         return false;
     }
     field_type = wasm_struct_type_get_field_type(struct_type, THIZ_INDEX, &mut);
-    field_type_idx = field_type.heap_type;
-    field_defined_type = wasm_get_defined_type(wasm_module, field_type_idx);
-    if (!wasm_defined_type_is_struct_type(field_defined_type)) {
+    field_defined_type = get_field_defined_type(wasm_module, field_type);
+    if (!field_defined_type
+        || !wasm_defined_type_is_struct_type(field_defined_type)) {
         return false;
     }
     field_type = wasm_struct_type_get_field_type(struct_type, FUNC_INDEX, &mut);
-    field_type_idx = field_type.heap_type;
-    field_defined_type = wasm_get_defined_type(wasm_module, field_type_idx);
-    if (!wasm_defined_type_is_func_type(field_defined_type)) {
+    field_defined_type = get_field_defined_type(wasm_module, field_type);
+    if (!field_defined_type
+        || !wasm_defined_type_is_func_type(field_defined_type)) {
         return false;
     }
 
@@ -97,15 +121,14 @@ is_ts_closure_type(wasm_module_t wasm_module, wasm_defined_type_t type)
     |  1:size  |      ^                           ^
     +----------+      |<-------  capacity  ------>|
 */
-bool
-is_ts_array_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+static bool
+check_ts_array_type(wasm_module_t wasm_module, wasm_defined_type_t type)
 {
     bool is_struct_type;
     wasm_struct_type_t struct_type;
     uint32_t field_count;
     bool mut;
     wasm_ref_type_t field_type;
-    uint32_t array_type_idx = 0;
     wasm_defined_type_t array_type;
 
     is_struct_type = wasm_defined_type_is_struct_type(type);
@@ -124,9 +147,8 @@ is_ts_array_type(wasm_module_t wasm_module, wasm_defined_type_t type)
         return false;
     }
     field_type = wasm_struct_type_get_field_type(struct_type, 0, &mut);
-    array_type_idx = field_type.heap_type;
-    array_type = wasm_get_defined_type(wasm_module, array_type_idx);
-    if (!mut || !wasm_defined_type_is_array_type(array_type)) {
+    array_type = get_field_defined_type(wasm_module, field_type);
+    if (!mut || !array_type || !wasm_defined_type_is_array_type(array_type)) {
         return false;
     }
 
@@ -247,11 +269,24 @@ get_closure_struct_type(wasm_module_t wasm_module,
     uint32_t field_count_in_ctx = 0;
     wasm_struct_type_t field_defined_type;
     bool mut;
+    TSTypeKindTable *table = get_ts_type_kind_table(wasm_module);
+
+    if (table && table->closure_struct_type_idx != -2) {
+        if (p_struct_type) {
+            *p_struct_type =
+                table->closure_struct_type_idx >= 0
+                    ? (wasm_struct_type_t)wasm_get_defined_type(
+                        wasm_module, table->closure_struct_type_idx)
+                    : NULL;
+        }
+        return table->closure_struct_type_idx;
+    }
 
     type_count = wasm_get_defined_type_count(wasm_module);
     for (i = 0; i < type_count; i++) {
         type = wasm_get_defined_type(wasm_module, i);
-        if (!is_ts_closure_type(wasm_module, type)) {
+        if (table ? table->infos[i].kind != TS_TYPE_KIND_CLOSURE
+                  : !is_ts_closure_type(wasm_module, type)) {
             continue;
         }
         field_type = wasm_struct_type_get_field_type((wasm_struct_type_t)type,
@@ -272,11 +307,17 @@ get_closure_struct_type(wasm_module_t wasm_module,
         if (field_count_in_ctx != 0) {
             continue;
         }
+        if (table) {
+            table->closure_struct_type_idx = i;
+        }
         if (p_struct_type) {
             *p_struct_type = (wasm_struct_type_t)type;
         }
         return i;
     }
+    if (table) {
+        table->closure_struct_type_idx = -1;
+    }
     if (p_struct_type) {
         *p_struct_type = NULL;
     }
@@ -382,6 +423,69 @@ create_wasm_array_with_string(wasm_exec_env_t exec_env, void **ptr,
     wasm_runtime_pop_local_object_ref(exec_env);
     return new_stringref_array_struct;
 }
+
+wasm_struct_obj_t
+create_wasm_array_with_stringref(wasm_exec_env_t exec_env, void **strs,
+                                 uint32_t arrlen)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    wasm_module_t module = wasm_runtime_get_module(module_inst);
+    wasm_local_obj_ref_t local_ref = { 0 };
+    wasm_array_type_t stringref_array_type = NULL;
+    wasm_struct_type_t res_arr_struct_type = NULL;
+    wasm_struct_obj_t res = NULL;
+    wasm_array_obj_t new_arr;
+    wasm_value_t val = { 0 };
+    uint32_t res_arr_type_idx, i = 0;
+
+    res_arr_type_idx = get_stringref_array_type(module, &stringref_array_type);
+    bh_assert(wasm_defined_type_is_array_type(
+        (wasm_defined_type_t)stringref_array_type));
+
+    get_array_struct_type(module, res_arr_type_idx, &res_arr_struct_type);
+    bh_assert(res_arr_struct_type != NULL);
+
+    new_arr = wasm_array_obj_new_with_type(exec_env, stringref_array_type,
+                                           arrlen, &val);
+    if (!new_arr) {
+        wasm_runtime_set_exception(module_inst, "alloc memory failed");
+        goto end;
+    }
+
+    /* Push object to local ref to avoid being freed at next allocation */
+    wasm_runtime_push_local_object_ref(exec_env, &local_ref);
+    local_ref.val = (wasm_obj_t)new_arr;
+
+    for (; i < arrlen; i++) {
+        val.gc_obj = (wasm_obj_t)wasm_stringref_obj_new(exec_env, strs[i]);
+        if (!val.gc_obj) {
+            wasm_runtime_set_exception(module_inst, "alloc memory failed");
+            goto pop_local_ref;
+        }
+        wasm_array_obj_set_elem(new_arr, i, &val);
+    }
+
+    res = wasm_struct_obj_new_with_type(exec_env, res_arr_struct_type);
+    if (!res) {
+        wasm_runtime_set_exception(module_inst, "alloc memory failed");
+        goto pop_local_ref;
+    }
+
+    val.gc_obj = (wasm_obj_t)new_arr;
+    wasm_struct_obj_set_field(res, 0, &val);
+
+    val.u32 = arrlen;
+    wasm_struct_obj_set_field(res, 1, &val);
+
+pop_local_ref:
+    wasm_runtime_pop_local_object_ref(exec_env);
+end:
+    /* release the strings not taken by the array */
+    for (; i < arrlen; i++) {
+        wasm_string_destroy((WASMString)strs[i]);
+    }
+    return res;
+}
 #else
 wasm_struct_obj_t
 create_wasm_array_with_string(wasm_exec_env_t exec_env, void **ptr,
@@ -520,6 +624,18 @@ get_string_array_type(wasm_module_t wasm_module,
 {
     uint32_t i, type_count;
     bool is_mutable = true;
+    TSTypeKindTable *table = get_ts_type_kind_table(wasm_module);
+
+    if (table && table->string_array_type_idx != -2) {
+        if (p_array_type_t) {
+            *p_array_type_t =
+                table->string_array_type_idx >= 0
+                    ? (wasm_array_type_t)wasm_get_defined_type(
+                        wasm_module, table->string_array_type_idx)
+                    : NULL;
+        }
+        return table->string_array_type_idx;
+    }
 
     type_count = wasm_get_defined_type_count(wasm_module);
     for (i = 0; i < type_count; i++) {
@@ -532,6 +648,9 @@ get_string_array_type(wasm_module_t wasm_module,
 
             if (arr_elem_ref_type.value_type == VALUE_TYPE_I8
                 && mutable == is_mutable) {
+                if (table) {
+                    table->string_array_type_idx = i;
+                }
                 if (p_array_type_t) {
                     *p_array_type_t = (wasm_array_type_t)type;
                 }
@@ -540,6 +659,9 @@ get_string_array_type(wasm_module_t wasm_module,
         }
     }
 
+    if (table) {
+        table->string_array_type_idx = -1;
+    }
     if (p_array_type_t) {
         *p_array_type_t = NULL;
     }
@@ -551,28 +673,37 @@ int32_t
 get_string_struct_type(wasm_module_t wasm_module,
                        wasm_struct_type_t *p_struct_type)
 {
-    uint32_t i, type_count;
-    wasm_defined_type_t type;
+    uint32_t i;
+    TSTypeKindTable *table = get_ts_type_kind_table(wasm_module);
 
-    type_count = wasm_get_defined_type_count(wasm_module);
-    for (i = 0; i < type_count; i++) {
-        type = wasm_get_defined_type(wasm_module, i);
-        if (!is_ts_string_type(wasm_module, type)) {
-            continue;
-        }
+    if (!table) {
         if (p_struct_type) {
-            *p_struct_type = (wasm_struct_type_t)type;
+            *p_struct_type = NULL;
+        }
+        return -1;
+    }
+
+    if (table->string_struct_type_idx == -2) {
+        table->string_struct_type_idx = -1;
+        for (i = 0; i < table->type_count; i++) {
+            if (table->infos[i].kind == TS_TYPE_KIND_STRING) {
+                table->string_struct_type_idx = i;
+                break;
+            }
         }
-        return i;
     }
+
     if (p_struct_type) {
-        *p_struct_type = NULL;
+        *p_struct_type = table->string_struct_type_idx >= 0
+                             ? (wasm_struct_type_t)wasm_get_defined_type(
+                                 wasm_module, table->string_struct_type_idx)
+                             : NULL;
     }
-    return -1;
+    return table->string_struct_type_idx;
 }
 
-bool
-is_ts_string_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+static bool
+check_ts_string_type(wasm_module_t wasm_module, wasm_defined_type_t type)
 {
     bool is_struct_type;
     wasm_struct_type_t struct_type;
@@ -604,6 +735,233 @@ is_ts_string_type(wasm_module_t wasm_module, wasm_defined_type_t type)
 }
 #endif /* end of WASM_ENABLE_STRINGREF == 0 */
 
+/*
+    type kind table
+
+    The TS kind of every defined type of a module is computed once when the
+    module is first inspected, the is_ts_xxx_type predicates are then a hash
+    lookup from the defined type (or an array load from the type index)
+    instead of a structural check of the type.
+*/
+#define TS_TYPE_HASH_EMPTY ((uint32_t)-1)
+
+static TSTypeKindTable *ts_type_kind_tables = NULL;
+
+static bool
+check_ts_object_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+{
+    /* field 0 is the vtable, and field 0 of the vtable is the meta */
+    wasm_ref_type_t field_type;
+    wasm_defined_type_t vtable_type;
+    bool mut;
+
+    if (!wasm_defined_type_is_struct_type(type)
+        || wasm_struct_type_get_field_count((wasm_struct_type_t)type) == 0) {
+        return false;
+    }
+
+    field_type =
+        wasm_struct_type_get_field_type((wasm_struct_type_t)type, 0, &mut);
+    vtable_type = get_field_defined_type(wasm_module, field_type);
+    if (!vtable_type || !wasm_defined_type_is_struct_type(vtable_type)
+        || wasm_struct_type_get_field_count((wasm_struct_type_t)vtable_type)
+               == 0) {
+        return false;
+    }
+
+    field_type = wasm_struct_type_get_field_type(
+        (wasm_struct_type_t)vtable_type, 0, &mut);
+    return field_type.value_type == VALUE_TYPE_I32;
+}
+
+static void
+init_ts_type_info(wasm_module_t wasm_module, wasm_defined_type_t type,
+                  ts_type_info_t *info)
+{
+    bool mut;
+
+    if (check_ts_array_type(wasm_module, type)) {
+        wasm_ref_type_t field_type =
+            wasm_struct_type_get_field_type((wasm_struct_type_t)type, 0, &mut);
+        info->kind = TS_TYPE_KIND_ARRAY;
+        info->elem_type = wasm_array_type_get_elem_type(
+            (wasm_array_type_t)wasm_get_defined_type(wasm_module,
+                                                     field_type.heap_type),
+            &mut);
+    }
+    else if (check_ts_closure_type(wasm_module, type)) {
+        info->kind = TS_TYPE_KIND_CLOSURE;
+    }
+#if WASM_ENABLE_STRINGREF == 0
+    else if (check_ts_string_type(wasm_module, type)) {
+        info->kind = TS_TYPE_KIND_STRING;
+    }
+#endif
+    else if (check_ts_object_type(wasm_module, type)) {
+        info->kind = TS_TYPE_KIND_OBJECT;
+    }
+    else {
+        info->kind = TS_TYPE_KIND_OTHER;
+    }
+}
+
+static TSTypeKindTable *
+create_ts_type_kind_table(wasm_module_t wasm_module)
+{
+    TSTypeKindTable *table;
+    wasm_defined_type_t type;
+    uint32_t i, type_count, hash_size, slot;
+    uint64 total_size;
+
+    type_count = wasm_get_defined_type_count(wasm_module);
+    hash_size = 8;
+    while (hash_size < type_count * 2) {
+        hash_size <<= 1;
+    }
+
+    total_size = offsetof(TSTypeKindTable, infos)
+                 + sizeof(ts_type_info_t) * (type_count ? type_count : 1);
+    if (!(table = wasm_runtime_malloc((uint32_t)total_size))) {
+        return NULL;
+    }
+    memset(table, 0, (uint32_t)total_size);
+
+    total_size = sizeof(TSTypeHashSlot) * hash_size;
+    if (!(table->hash_slots = wasm_runtime_malloc((uint32_t)total_size))) {
+        wasm_runtime_free(table);
+        return NULL;
+    }
+    for (i = 0; i < hash_size; i++) {
+        table->hash_slots[i].type = NULL;
+        table->hash_slots[i].type_idx = TS_TYPE_HASH_EMPTY;
+    }
+
+    table->module = wasm_module;
+    table->type_count = type_count;
+    table->hash_mask = hash_size - 1;
+    table->closure_struct_type_idx = -2;
+    table->string_struct_type_idx = -2;
+    table->string_array_type_idx = -2;
+
+    for (i = 0; i < type_count; i++) {
+        type = wasm_get_defined_type(wasm_module, i);
+        init_ts_type_info(wasm_module, type, &table->infos[i]);
+
+        slot = TS_TYPE_HASH(type, table->hash_mask);
+        while (table->hash_slots[slot].type_idx != TS_TYPE_HASH_EMPTY
+               && table->hash_slots[slot].type != type) {
+            slot = (slot + 1) & table->hash_mask;
+        }
+        if (table->hash_slots[slot].type_idx == TS_TYPE_HASH_EMPTY) {
+            table->hash_slots[slot].type = type;
+            table->hash_slots[slot].type_idx = i;
+        }
+    }
+
+    table->next = ts_type_kind_tables;
+    ts_type_kind_tables = table;
+    return table;
+}
+
+TSTypeKindTable *
+get_ts_type_kind_table(wasm_module_t wasm_module)
+{
+    TSTypeKindTable *table, *prev;
+
+    /* the table of the running module is kept at the head of the list, so
+     * the lookup is a single compare in the common case */
+    if (ts_type_kind_tables && ts_type_kind_tables->module == wasm_module) {
+        return ts_type_kind_tables;
+    }
+
+    prev = ts_type_kind_tables;
+    for (table = prev ? prev->next : NULL; table;
+         prev = table, table = table->next) {
+        if (table->module == wasm_module) {
+            prev->next = table->next;
+            table->next = ts_type_kind_tables;
+            ts_type_kind_tables = table;
+            return table;
+        }
+    }
+
+    return create_ts_type_kind_table(wasm_module);
+}
+
+void
+destroy_ts_type_kind_tables()
+{
+    TSTypeKindTable *table, *next;
+
+    for (table = ts_type_kind_tables; table; table = next) {
+        next = table->next;
+        wasm_runtime_free(table->hash_slots);
+        wasm_runtime_free(table);
+    }
+    ts_type_kind_tables = NULL;
+}
+
+const ts_type_info_t *
+get_ts_type_info_by_idx(wasm_module_t wasm_module, uint32_t type_idx)
+{
+    TSTypeKindTable *table = get_ts_type_kind_table(wasm_module);
+
+    if (!table || type_idx >= table->type_count) {
+        return NULL;
+    }
+
+    return &table->infos[type_idx];
+}
+
+const ts_type_info_t *
+get_ts_type_info(wasm_module_t wasm_module, wasm_defined_type_t type)
+{
+    TSTypeKindTable *table = get_ts_type_kind_table(wasm_module);
+    uint32_t slot;
+
+    if (!table) {
+        return NULL;
+    }
+
+    slot = TS_TYPE_HASH(type, table->hash_mask);
+    while (table->hash_slots[slot].type_idx != TS_TYPE_HASH_EMPTY) {
+        if (table->hash_slots[slot].type == type) {
+            return &table->infos[table->hash_slots[slot].type_idx];
+        }
+        slot = (slot + 1) & table->hash_mask;
+    }
+
+    return NULL;
+}
+
+static ts_type_kind_t
+get_ts_type_kind(wasm_module_t wasm_module, wasm_defined_type_t type)
+{
+    const ts_type_info_t *info = get_ts_type_info(wasm_module, type);
+
+    return info ? info->kind : TS_TYPE_KIND_OTHER;
+}
+
+bool
+is_ts_closure_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+{
+    return get_ts_type_kind(wasm_module, type) == TS_TYPE_KIND_CLOSURE;
+}
+
+bool
+is_ts_array_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+{
+    return get_ts_type_kind(wasm_module, type) == TS_TYPE_KIND_ARRAY;
+}
+
+#if WASM_ENABLE_STRINGREF == 0
+bool
+is_ts_string_type(wasm_module_t wasm_module, wasm_defined_type_t type)
+{
+    return get_ts_type_kind(wasm_module, type) == TS_TYPE_KIND_STRING;
+}
+#endif
+
 #if WASM_ENABLE_STRINGREF != 0
 wasm_stringref_obj_t
 create_wasm_string(wasm_exec_env_t exec_env, const char *str)
@@ -616,15 +974,14 @@ create_wasm_string_with_len(wasm_exec_env_t exec_env, const char *str,
                             uint32_t len)
 {
     return wasm_stringref_obj_new(
-        exec_env, wasm_string_new_with_encoding((void *)str, len, WTF16));
+        exec_env, wasm_string_new_with_encoding((void *)str, len, WTF8));
 }
 
 uint32_t
 wasm_string_get_length(wasm_stringref_obj_t str_obj)
 {
     WASMString str = (WASMString)wasm_stringref_obj_get_value(str_obj);
-    return wasm_string_encode(str, 0, wasm_string_measure(str, WTF16), NULL,
-                              NULL, WTF16);
+    return wasm_string_measure(str, WTF8);
 }
 
 uint32_t
@@ -634,13 +991,33 @@ wasm_string_to_cstring(wasm_stringref_obj_t str_obj, char *buffer,
     WASMString str = (WASMString)wasm_stringref_obj_get_value(str_obj);
     uint32_t strlen;
     strlen = wasm_string_encode(str, 0, wasm_string_measure(str, WTF16),
-                              (char *)buffer, NULL, WTF16);
+                              (char *)buffer, NULL, WTF8);
     *(char *)(buffer + strlen) = '\0';
     return strlen;
 }
 #else
 wasm_struct_obj_t
 create_wasm_string(wasm_exec_env_t exec_env, const char *value)
+{
+    return create_wasm_string_with_len(exec_env, value, strlen(value));
+}
+
+wasm_struct_obj_t
+create_wasm_string_with_len(wasm_exec_env_t exec_env, const char *value,
+                            uint32_t len)
+{
+    char *data;
+    wasm_struct_obj_t new_string_struct =
+        alloc_wasm_string(exec_env, len, &data);
+
+    if (new_string_struct) {
+        bh_memcpy_s(data, len, value, len);
+    }
+    return new_string_struct;
+}
+
+wasm_struct_obj_t
+alloc_wasm_string(wasm_exec_env_t exec_env, uint32_t len, char **p_data)
 {
     wasm_struct_type_t string_struct_type = NULL;
     wasm_array_type_t string_array_type = NULL;
@@ -648,14 +1025,9 @@ create_wasm_string(wasm_exec_env_t exec_env, const char *value)
     wasm_value_t val = { 0 };
     wasm_struct_obj_t new_string_struct = NULL;
     wasm_array_obj_t new_arr;
-    int len = 0;
-    char *p, *p_end;
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     wasm_module_t module = wasm_runtime_get_module(module_inst);
 
-    /* get string len */
-    len = strlen(value);
-
     /* get struct_string_type */
     get_string_struct_type(module, &string_struct_type);
     bh_assert(string_struct_type != NULL);
@@ -685,21 +1057,14 @@ create_wasm_string(wasm_exec_env_t exec_env, const char *value)
         return NULL;
     }
 
-    p = (char *)wasm_array_obj_first_elem_addr(new_arr);
-    p_end = p + len;
-    bh_assert(p);
-    bh_assert(p_end);
-
-    bh_memcpy_s(p, len, value, len);
-    p += len;
-    bh_assert(p == p_end);
+    *p_data = (char *)wasm_array_obj_first_elem_addr(new_arr);
+    bh_assert(*p_data);
 
     val.gc_obj = (wasm_obj_t)new_arr;
     wasm_struct_obj_set_field(new_string_struct, 1, &val);
 
     wasm_runtime_pop_local_object_ref(exec_env);
 
-    (void)p_end;
     return new_string_struct;
 }
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
@@ -1083,20 +1448,17 @@ fail:
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
 
 void
-get_static_array_info(wasm_exec_env_t exec_env, uint32_t tbl_idx,
+get_static_array_info(wasm_exec_env_t exec_env, wasm_obj_t static_arr_struct,
                       WasmArrayInfo *p_arr_info)
 {
-    void *static_arr_struct = NULL;
     wasm_defined_type_t static_arr_arr_type = { 0 };
     bool mutable = false;
     wasm_array_obj_t arr_ref = NULL;
     uint32_t arr_len = 0;
     wasm_ref_type_t arr_elem_ref_type = { 0 };
 
-    static_arr_struct =
-        (wasm_struct_obj_t)wamr_utils_get_table_element(exec_env, tbl_idx);
-    arr_ref = get_array_ref(static_arr_struct);
-    arr_len = get_array_length(static_arr_struct);
+    arr_ref = get_array_ref((wasm_struct_obj_t)static_arr_struct);
+    arr_len = get_array_length((wasm_struct_obj_t)static_arr_struct);
     static_arr_arr_type = wasm_obj_get_defined_type((wasm_obj_t)arr_ref);
     arr_elem_ref_type = wasm_array_type_get_elem_type(
         (wasm_array_type_t)static_arr_arr_type, &mutable);
@@ -1111,37 +1473,45 @@ int
 get_prop_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
                          wasm_obj_t *wasm_obj, wasm_ref_type_t *field_type)
 {
-    wasm_module_inst_t module_inst;
+    int property_flag;
+
+    return get_prop_flag_and_index_of_struct(exec_env, prop, wasm_obj,
+                                             field_type, &property_flag);
+}
+
+static void *
+find_meta_field_by_name(wasm_exec_env_t exec_env, void *meta,
+                        const char *name, enum field_flag flag);
+
+static inline int32
+get_meta_field_flag_and_index(void *meta_field);
+
+int
+get_prop_flag_and_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
+                                  wasm_obj_t *wasm_obj,
+                                  wasm_ref_type_t *field_type,
+                                  int *p_property_flag)
+{
     bool is_mut;
-    wasm_function_inst_t func;
     wasm_struct_obj_t wasm_struct_obj;
     WASMValue vtable_value = { 0 };
-    WASMValue meta = { 0 };
-    uint32_t argc = 3, argv[3] = { 0 }, offset;
     wasm_struct_type_t struct_type;
     wasm_struct_type_t vtable_type;
+    void *meta_field;
+    int32 flag_and_index;
     int property_flag = -1;
     int property_index = -1;
 
-    module_inst = wasm_runtime_get_module_inst(exec_env);
     wasm_struct_obj = (wasm_struct_obj_t)(*wasm_obj);
     wasm_struct_obj_get_field(wasm_struct_obj, 0, false, &vtable_value);
-    wasm_struct_obj_get_field((wasm_struct_obj_t)vtable_value.gc_obj, 0, false,
-                              &meta);
     struct_type = (wasm_struct_type_t)wasm_obj_get_defined_type(*wasm_obj);
-    func = wasm_runtime_lookup_function(module_inst,
-                                        "find_property_flag_and_index", NULL);
-    bh_assert(func);
-
-    argv[0] = meta.i32;
-    offset = wasm_runtime_addr_native_to_app(module_inst, (void *)prop);
-    argv[1] = offset;
-    argv[2] = ALL;
-
-    wasm_runtime_call_wasm(exec_env, func, argc, argv);
-    if (argv[0] != -1) {
-        property_flag = argv[0] & META_FLAG_MASK;
-        property_index = (argv[0] & META_INDEX_MASK) >> 4;
+
+    meta_field = find_meta_field_by_name(
+        exec_env, get_meta_of_object(exec_env, *wasm_obj), prop, ALL);
+    if (meta_field) {
+        flag_and_index = get_meta_field_flag_and_index(meta_field);
+        property_flag = flag_and_index & META_FLAG_MASK;
+        property_index = (flag_and_index & META_INDEX_MASK) >> 4;
         if (property_flag == METHOD) {
             vtable_type = (wasm_struct_type_t)wasm_obj_get_defined_type(
                 vtable_value.gc_obj);
@@ -1154,6 +1524,7 @@ get_prop_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
         }
     }
 
+    *p_property_flag = property_flag;
     return property_index;
 }
 
@@ -1200,75 +1571,208 @@ get_meta_field_name(void *meta_field)
     return *((int32 *)meta_field);
 }
 
-static int32
-get_object_field_index_by_mata(wasm_exec_env_t exec_env, void *meta,
-                               const char *field_name, enum field_flag flag,
-                               ts_value_type_t *field_type)
+static inline int32
+get_meta_field_flag_and_index(void *meta_field)
 {
-    int32 count;
+    return *((int32 *)(meta_field + OFFSET_OF_FIELD_FLAG_AND_INDEX));
+}
+
+/*
+    meta name index
+
+    The fields of a meta are hashed by name the first time the meta is
+    searched by name, so a lookup doesn't need to walk and strcmp all the
+    fields. The names are kept as app offsets since the native address of
+    the linear memory may change when it grows. Fields sharing a name (e.g.
+    getter and setter) are inserted in meta order, so a lookup finds them
+    in meta order too.
+*/
+#define META_NAME_INDEX_BUCKETS 64
+
+typedef struct MetaNameSlot {
+    uint32 hash;
+    /* index of the field in meta, -1 if the slot is empty */
+    int32 field_index;
+} MetaNameSlot;
+
+typedef struct MetaNameIndex {
+    struct MetaNameIndex *next;
+    wasm_module_inst_t module_inst;
+    uint32 meta_offset;
+    uint32 hash_mask;
+    MetaNameSlot slots[1];
+} MetaNameIndex;
+
+static MetaNameIndex *meta_name_indexes[META_NAME_INDEX_BUCKETS];
+
+static MetaNameIndex *
+create_meta_name_index(wasm_module_inst_t module_inst, void *meta,
+                       uint32 meta_offset)
+{
+    MetaNameIndex *index;
+    const char *name;
+    uint32 i, count, slot_count, slot, hash;
+    uint64 total_size;
+
+    count = (uint32)get_meta_fields_count(meta);
+    slot_count = 4;
+    while (slot_count < count * 2) {
+        slot_count <<= 1;
+    }
+
+    total_size = offsetof(MetaNameIndex, slots)
+                 + sizeof(MetaNameSlot) * (uint64)slot_count;
+    if (!(index = wasm_runtime_malloc((uint32)total_size))) {
+        return NULL;
+    }
+    index->module_inst = module_inst;
+    index->meta_offset = meta_offset;
+    index->hash_mask = slot_count - 1;
+    for (i = 0; i < slot_count; i++) {
+        index->slots[i].field_index = -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        name = wasm_runtime_addr_app_to_native(
+            module_inst, get_meta_field_name(get_meta_field_by_index(meta, i)));
+        if (!name) {
+            continue;
+        }
+        hash = hash_field_name(name);
+        slot = hash & index->hash_mask;
+        while (index->slots[slot].field_index != -1) {
+            slot = (slot + 1) & index->hash_mask;
+        }
+        index->slots[slot].hash = hash;
+        index->slots[slot].field_index = (int32)i;
+    }
+
+    return index;
+}
+
+static MetaNameIndex *
+get_meta_name_index(wasm_module_inst_t module_inst, void *meta)
+{
+    uint32 meta_offset = wasm_runtime_addr_native_to_app(module_inst, meta);
+    uint32 bucket = (meta_offset >> 2) % META_NAME_INDEX_BUCKETS;
+    MetaNameIndex *index;
+
+    for (index = meta_name_indexes[bucket]; index; index = index->next) {
+        if (index->meta_offset == meta_offset
+            && index->module_inst == module_inst) {
+            return index;
+        }
+    }
+
+    if (!(index = create_meta_name_index(module_inst, meta, meta_offset))) {
+        return NULL;
+    }
+    index->next = meta_name_indexes[bucket];
+    meta_name_indexes[bucket] = index;
+    return index;
+}
+
+void
+destroy_meta_name_indexes()
+{
+    MetaNameIndex *index, *next;
+    uint32 i;
+
+    for (i = 0; i < META_NAME_INDEX_BUCKETS; i++) {
+        for (index = meta_name_indexes[i]; index; index = next) {
+            next = index->next;
+            wasm_runtime_free(index);
+        }
+        meta_name_indexes[i] = NULL;
+    }
+}
+
+static inline bool
+is_meta_field_matched(wasm_module_inst_t module_inst, void *meta_field,
+                      const char *name, enum field_flag flag)
+{
+    const char *field_name =
+        wasm_runtime_addr_app_to_native(module_inst,
+                                        get_meta_field_name(meta_field));
+
+    return field_name && strcmp(field_name, name) == 0
+           && (flag == ALL || get_meta_field_flag(meta_field) == flag);
+}
+
+/* find the meta field by name and flag, ALL matches any flag */
+static void *
+find_meta_field_by_name(wasm_exec_env_t exec_env, void *meta,
+                        const char *name, enum field_flag flag)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    MetaNameIndex *index;
     void *meta_field;
-    enum field_flag meta_field_flag;
-    int32 meta_field_name_offset;
-    const char *meta_field_name;
-    int32 meta_field_index;
-    int32 field_type_id;
+    uint32 hash, slot;
+    int32 i, count;
 
-    count = get_meta_fields_count(meta);
-    meta_field_index = -1;
+    if (!meta || !name) {
+        return NULL;
+    }
 
-    for (int index = 0; index < count; index++) {
-        meta_field = get_meta_field_by_index(meta, index);
-        meta_field_flag = get_meta_field_flag(meta_field);
-        meta_field_name_offset = get_meta_field_name(meta_field);
-        meta_field_name = wasm_runtime_addr_app_to_native(
-            wasm_runtime_get_module_inst(exec_env), meta_field_name_offset);
+    if (!(index = get_meta_name_index(module_inst, meta))) {
+        /* out of memory, fall back to linear search */
+        count = get_meta_fields_count(meta);
+        for (i = 0; i < count; i++) {
+            meta_field = get_meta_field_by_index(meta, i);
+            if (is_meta_field_matched(module_inst, meta_field, name, flag)) {
+                return meta_field;
+            }
+        }
+        return NULL;
+    }
 
-        if (meta_field_flag == flag
-            && strcmp(field_name, meta_field_name) == 0) {
-            meta_field_index = get_meta_field_index(meta_field);
-            if (field_type) {
-                field_type_id = get_meta_field_type(meta_field);
-                if (field_type_id >= CUSTOM_TYPE_BEGIN) {
-                    *field_type = TS_OBJECT;
-                }
-                else {
-                    *field_type = (ts_value_type_t)field_type_id;
-                }
+    hash = hash_field_name(name);
+    slot = hash & index->hash_mask;
+    while (index->slots[slot].field_index != -1) {
+        if (index->slots[slot].hash == hash) {
+            meta_field =
+                get_meta_field_by_index(meta, index->slots[slot].field_index);
+            if (is_meta_field_matched(module_inst, meta_field, name, flag)) {
+                return meta_field;
             }
-            break;
         }
+        slot = (slot + 1) & index->hash_mask;
     }
 
-    return meta_field_index;
+    return NULL;
 }
 
-int
-get_object_field(wasm_exec_env_t exec_env, wasm_obj_t obj,
-                 const char *field_name, enum field_flag flag,
-                 ts_value_t *field_value)
+static void *
+get_object_field_by_meta(wasm_exec_env_t exec_env, void *meta,
+                         const char *field_name, enum field_flag flag,
+                         ts_value_type_t *field_type)
 {
-    void *meta_addr;
-    int32 field_index;
-    wasm_struct_obj_t vtable_struct;
-    WASMValue vtable_value = { 0 };
-    wasm_value_t value = { 0 };
+    void *meta_field;
+    int32 field_type_id;
 
-    wasm_struct_obj_get_field((wasm_struct_obj_t)obj, 0, false, &vtable_value);
-    vtable_struct = (wasm_struct_obj_t)vtable_value.gc_obj;
+    meta_field = find_meta_field_by_name(exec_env, meta, field_name, flag);
+    if (meta_field && field_type) {
+        field_type_id = get_meta_field_type(meta_field);
+        if (field_type_id >= CUSTOM_TYPE_BEGIN) {
+            *field_type = TS_OBJECT;
+        }
+        else {
+            *field_type = (ts_value_type_t)field_type_id;
+        }
+    }
 
-    /* get meta addr of obj */
-    meta_addr = get_meta_of_object(exec_env, obj);
+    return meta_field;
+}
 
-    /* get field index */
-    field_index = get_object_field_index_by_mata(
-        exec_env, meta_addr, field_name, flag, &field_value->type);
-    if (field_index == -1) {
-        return -1;
-    }
+static void
+read_object_field(wasm_struct_obj_t obj, wasm_struct_obj_t vtable_struct,
+                  void *meta_field, ts_value_t *field_value)
+{
+    wasm_value_t value = { 0 };
+    int32 field_index = get_meta_field_index(meta_field);
 
-    if (flag == FIELD) {
-        wasm_struct_obj_get_field((wasm_struct_obj_t)obj, field_index, false,
-                                  &value);
+    if (get_meta_field_flag(meta_field) == FIELD) {
+        wasm_struct_obj_get_field(obj, field_index, false, &value);
     }
     else {
         wasm_struct_obj_get_field(vtable_struct, field_index, false, &value);
@@ -1283,10 +1787,68 @@ get_object_field(wasm_exec_env_t exec_env, wasm_obj_t obj,
     else {
         field_value->of.ref = value.gc_obj;
     }
+}
+
+int
+get_object_field(wasm_exec_env_t exec_env, wasm_obj_t obj,
+                 const char *field_name, enum field_flag flag,
+                 ts_value_t *field_value)
+{
+    void *meta_addr;
+    void *meta_field;
+    WASMValue vtable_value = { 0 };
+
+    wasm_struct_obj_get_field((wasm_struct_obj_t)obj, 0, false, &vtable_value);
+
+    /* get meta addr of obj */
+    meta_addr = get_meta_of_object(exec_env, obj);
+
+    /* get field */
+    meta_field = get_object_field_by_meta(exec_env, meta_addr, field_name,
+                                          flag, &field_value->type);
+    if (!meta_field) {
+        return -1;
+    }
 
+    read_object_field((wasm_struct_obj_t)obj,
+                      (wasm_struct_obj_t)vtable_value.gc_obj, meta_field,
+                      field_value);
     return 0;
 }
 
+int
+get_object_fields(wasm_exec_env_t exec_env, wasm_obj_t obj,
+                  const char **field_names, uint32_t count,
+                  enum field_flag flag, ts_value_t *field_values)
+{
+    void *meta_addr;
+    void *meta_field;
+    WASMValue vtable_value = { 0 };
+    uint32_t i;
+    int found = 0;
+
+    /* the vtable and meta are resolved once for all the fields */
+    wasm_struct_obj_get_field((wasm_struct_obj_t)obj, 0, false, &vtable_value);
+    meta_addr = get_meta_of_object(exec_env, obj);
+
+    for (i = 0; i < count; i++) {
+        meta_field = get_object_field_by_meta(
+            exec_env, meta_addr, field_names[i], flag, &field_values[i].type);
+        if (!meta_field) {
+            field_values[i].type = TS_NULL;
+            field_values[i].of.ref = NULL;
+            continue;
+        }
+
+        read_object_field((wasm_struct_obj_t)obj,
+                          (wasm_struct_obj_t)vtable_value.gc_obj, meta_field,
+                          &field_values[i]);
+        found++;
+    }
+
+    return found;
+}
+
 void *
 get_meta_of_object(wasm_exec_env_t exec_env, wasm_obj_t obj)
 {
@@ -1329,3 +1891,16 @@ get_field_name_from_meta_index(wasm_exec_env_t exec_env, void *meta,
     }
     return NULL;
 }
+
+int32
+find_meta_property(wasm_exec_env_t exec_env, void *meta, const char *prop_name,
+                   enum field_flag flag, int32 *p_prop_type)
+{
+    void *meta_field =
+        find_meta_field_by_name(exec_env, meta, prop_name, flag);
+
+    if (p_prop_type) {
+        *p_prop_type = meta_field ? get_meta_field_type(meta_field) : -1;
+    }
+    return meta_field ? get_meta_field_flag_and_index(meta_field) : -1;
+}
@@ -92,6 +92,63 @@ typedef struct ts_value_t {
 
 } ts_value_t;
 
+typedef enum ts_type_kind_t {
+    TS_TYPE_KIND_OTHER = 0,
+    /* array struct: { data: array, size: i32 } */
+    TS_TYPE_KIND_ARRAY,
+    /* closure struct: { context, thiz, func } */
+    TS_TYPE_KIND_CLOSURE,
+    /* string struct: { flag: i32, data: i8 array }, no stringref only */
+    TS_TYPE_KIND_STRING,
+    /* object struct (class instance, object literal): { vtable, ... } */
+    TS_TYPE_KIND_OBJECT,
+} ts_type_kind_t;
+
+typedef struct ts_type_info_t {
+    ts_type_kind_t kind;
+    /* element type of the data array, only valid for TS_TYPE_KIND_ARRAY */
+    wasm_ref_type_t elem_type;
+} ts_type_info_t;
+
+typedef struct TSTypeHashSlot {
+    wasm_defined_type_t type;
+    uint32_t type_idx;
+} TSTypeHashSlot;
+
+#define TS_TYPE_HASH(type, mask) \
+    ((uint32_t)(((uintptr_t)(type) >> 3) * 2654435761u) & (mask))
+
+/* TS kinds of all the defined types of a module */
+typedef struct TSTypeKindTable {
+    struct TSTypeKindTable *next;
+    wasm_module_t module;
+    uint32_t type_count;
+    uint32_t hash_mask;
+    /* -2 if not resolved yet */
+    int32_t closure_struct_type_idx;
+    int32_t string_struct_type_idx;
+    int32_t string_array_type_idx;
+    /* open addressing hash from defined type to its index */
+    TSTypeHashSlot *hash_slots;
+    ts_type_info_t infos[1];
+} TSTypeKindTable;
+
+/* get the type kind table of a module, it's created when the module is first
+ * inspected */
+TSTypeKindTable *
+get_ts_type_kind_table(wasm_module_t wasm_module);
+
+/* release the type kind tables, must be called before the modules are
+ * unloaded */
+void
+destroy_ts_type_kind_tables();
+
+const ts_type_info_t *
+get_ts_type_info(wasm_module_t wasm_module, wasm_defined_type_t type);
+
+const ts_type_info_t *
+get_ts_type_info_by_idx(wasm_module_t wasm_module, uint32_t type_idx);
+
 /* whether the type is struct(struct_func) */
 bool
 is_ts_closure_type(wasm_module_t wasm_module, wasm_defined_type_t type);
@@ -130,6 +187,14 @@ get_closure_struct_type(wasm_module_t wasm_module,
 wasm_struct_obj_t
 create_wasm_array_with_string(wasm_exec_env_t exec_env, void **ptr, uint32_t arrlen);
 
+#if WASM_ENABLE_STRINGREF != 0
+/* create string array from the stringrefs, the array takes over the
+ * references of the strings */
+wasm_struct_obj_t
+create_wasm_array_with_stringref(wasm_exec_env_t exec_env, void **strs,
+                                 uint32_t arrlen);
+#endif
+
 /* get string struct type*/
 int32_t
 get_string_struct_type(wasm_module_t wasm_module,
@@ -164,6 +229,17 @@ wasm_string_to_cstring(wasm_stringref_obj_t str_obj, char *buffer,
 #else
 wasm_struct_obj_t
 create_wasm_string(wasm_exec_env_t exec_env, const char *value);
+
+/* create wasm string from the first len bytes of value, the bytes are copied
+ * into the string array directly */
+wasm_struct_obj_t
+create_wasm_string_with_len(wasm_exec_env_t exec_env, const char *value,
+                            uint32_t len);
+
+/* create wasm string of len bytes, *p_data is set to the string array to be
+ * filled by the caller before anything else is allocated */
+wasm_struct_obj_t
+alloc_wasm_string(wasm_exec_env_t exec_env, uint32_t len, char **p_data);
 #endif
 
 
@@ -179,7 +255,7 @@ typedef struct WasmArrayInfo {
 } WasmArrayInfo;
 
 void
-get_static_array_info(wasm_exec_env_t exec_env, uint32_t tbl_idx,
+get_static_array_info(wasm_exec_env_t exec_env, wasm_obj_t static_arr_struct,
                       WasmArrayInfo *p_arr_info);
 
 /* get property of a struct
@@ -189,6 +265,14 @@ int
 get_prop_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
                          wasm_obj_t *wasm_obj, wasm_ref_type_t *field_type);
 
+/* same as get_prop_index_of_struct, and also return the property flag
+ * (FIELD, METHOD, ...) through p_property_flag, -1 if not found */
+int
+get_prop_flag_and_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
+                                  wasm_obj_t *wasm_obj,
+                                  wasm_ref_type_t *field_type,
+                                  int *p_property_flag);
+
 /**
  * @brief Access object field through meta information
  *
@@ -205,6 +289,41 @@ get_object_field(wasm_exec_env_t exec_env,
                  enum field_flag flag,
                  ts_value_t *field_value);
 
+/**
+ * @brief Access several fields of object through meta information, the meta
+ * is resolved once for all the names and each name is found through the
+ * hashed name index of the meta
+ *
+ * @param obj object
+ * @param field_names the specified field names
+ * @param count number of field names
+ * @param flag field flag
+ * @param field_values the values of the fields, a field which is not found is
+ * set to TS_NULL
+ * @result number of fields found
+*/
+int
+get_object_fields(wasm_exec_env_t exec_env, wasm_obj_t obj,
+                  const char **field_names, uint32_t count,
+                  enum field_flag flag, ts_value_t *field_values);
+
+/* release the name indexes built for the metas */
+void
+destroy_meta_name_indexes();
+
+/* FNV-1a hash of a field name, shared by the name indexes of the metas and
+ * the struct-indirect inline caches */
+static inline uint32_t
+hash_field_name(const char *name)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+
 /* get str from a string struct */
 const char *
 get_str_from_string_struct(wasm_struct_obj_t obj);
@@ -273,4 +392,17 @@ const char *
 get_field_name_from_meta_index(wasm_exec_env_t exec_env, void *meta,
                                enum field_flag flag, uint32_t index);
 
+/**
+ * @brief find a property in meta info by name, the same as
+ * find_property_flag_and_index in the generated code.
+ * @param meta meta pointer
+ * @param prop_name property name
+ * @param flag property flag, ALL matches any flag
+ * @param p_prop_type if not NULL, return the type id of the property
+ * @result : flag and index of the property, or -1 if not found.
+ */
+int32
+find_meta_property(wasm_exec_env_t exec_env, void *meta, const char *prop_name,
+                   enum field_flag flag, int32 *p_prop_type);
+
 #endif /* end of __TYPE_UTILS_H_ */
@@ -26,6 +26,7 @@ set(STRINGREF_DIR ${CMAKE_CURRENT_LIST_DIR}/stringref)
 set(WAMR_STRINGREF_IMPL_SOURCE
     ${STRINGREF_DIR}/stringref_qjs.c
 )
+include_directories(${STRINGREF_DIR})
 
 if (WAMR_GC_IN_EVERY_ALLOCATION EQUAL 1)
     message("* Garbage collection in every allocation: on")
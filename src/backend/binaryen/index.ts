@@ -13,17 +13,12 @@ import {
     generateGlobalContext,
     addItableFunc,
     generateGlobalJSObject,
-    generateExtRefTableMaskArr,
     generateDynContext,
 } from './lib/env_init.js';
 import { WASMTypeGen } from './wasm_type_gen.js';
 import { WASMExpressionGen } from './wasm_expr_gen.js';
 import { WASMStatementGen } from './wasm_stmt_gen.js';
-import {
-    initGlobalOffset,
-    initDefaultMemory,
-    initDefaultTable,
-} from './memory.js';
+import { initGlobalOffset, initDefaultMemory } from './memory.js';
 import { BuiltinNames } from '../../../lib/builtin/builtin_name.js';
 import { Ts2wasmBackend, ParserContext, DataSegmentContext } from '../index.js';
 import { Logger } from '../../log.js';
@@ -405,7 +400,6 @@ export class WASMGen extends Ts2wasmBackend {
         UtilFuncs.clearWasmStringMap();
         FunctionalFuncs.resetDynContextRef();
 
-        initDefaultTable(this.module);
         /* init builtin APIs */
         callBuiltInAPIs(this.module);
         /* init any lib APIs */
@@ -437,7 +431,6 @@ export class WASMGen extends Ts2wasmBackend {
         this.parseFuncs();
 
         generateGlobalContext(this.module);
-        generateExtRefTableMaskArr(this.module);
         BuiltinNames.JSGlobalObjects.forEach((key) => {
             generateGlobalJSObject(this.module, key);
             /* Insert at the second slot (right after dyntype context initialized) */
@@ -54,6 +54,7 @@ export namespace dyntype {
     export const dyntype_add_elem = 'dyntype_add_elem';
     export const dyntype_set_elem = 'dyntype_set_elem';
     export const dyntype_get_elem = 'dyntype_get_elem';
+    export const dyntype_get_array_length = 'dyntype_get_array_length';
     export const dyntype_new_extref = 'dyntype_new_extref';
     export const dyntype_set_property = 'dyntype_set_property';
     export const dyntype_define_property = 'dyntype_define_property';
@@ -119,5 +120,7 @@ export namespace structdyn {
         struct_set_indirect_f64 = 'struct_set_indirect_f64',
         struct_set_indirect_anyref = 'struct_set_indirect_anyref',
         struct_set_indirect_funcref = 'struct_set_indirect_funcref',
+        struct_ic_find_flag_and_index = 'struct_ic_find_flag_and_index',
+        struct_ic_find_type = 'struct_ic_find_type',
     }
 }
@@ -10,8 +10,6 @@ import path from 'path';
 import { fileURLToPath } from 'url';
 import { UtilFuncs } from '../utils.js';
 import { BuiltinNames } from '../../../../lib/builtin/builtin_name.js';
-import { getBuiltInFuncName } from '../../../utils.js';
-import { charArrayTypeInfo } from '../glue/packType.js';
 import { _BinaryenTypeStringref } from '../glue/binaryen.js';
 
 export function importAnyLibAPI(module: binaryen.Module) {
@@ -166,6 +164,13 @@ export function importAnyLibAPI(module: binaryen.Module) {
         ]),
         dyntype.dyn_value_t,
     );
+    module.addFunctionImport(
+        dyntype.dyntype_get_array_length,
+        dyntype.module_name,
+        dyntype.dyntype_get_array_length,
+        binaryen.createType([dyntype.dyn_ctx_t, dyntype.dyn_value_t]),
+        dyntype.int,
+    );
     module.addFunctionImport(
         dyntype.dyntype_is_array,
         dyntype.module_name,
@@ -231,7 +236,7 @@ export function importAnyLibAPI(module: binaryen.Module) {
         dyntype.dyntype_new_extref,
         binaryen.createType([
             dyntype.dyn_ctx_t,
-            dyntype.pointer,
+            binaryen.anyref,
             dyntype.external_ref_tag,
         ]),
         dyntype.dyn_value_t,
@@ -248,7 +253,7 @@ export function importAnyLibAPI(module: binaryen.Module) {
         dyntype.module_name,
         dyntype.dyntype_to_extref,
         binaryen.createType([dyntype.dyn_ctx_t, dyntype.dyn_value_t]),
-        dyntype.int,
+        binaryen.anyref,
     );
     module.addFunctionImport(
         dyntype.dyntype_instanceof,
@@ -461,6 +466,32 @@ export function importInfcLibAPI(module: binaryen.Module) {
         binaryen.createType([binaryen.anyref, binaryen.i32, binaryen.funcref]),
         binaryen.none,
     );
+
+    module.addFunctionImport(
+        structdyn.StructDyn.struct_ic_find_flag_and_index,
+        structdyn.module_name,
+        structdyn.StructDyn.struct_ic_find_flag_and_index,
+        binaryen.createType([
+            binaryen.i32,
+            binaryen.i32,
+            binaryen.i32,
+            binaryen.i32,
+        ]),
+        binaryen.i32,
+    );
+
+    module.addFunctionImport(
+        structdyn.StructDyn.struct_ic_find_type,
+        structdyn.module_name,
+        structdyn.StructDyn.struct_ic_find_type,
+        binaryen.createType([
+            binaryen.i32,
+            binaryen.i32,
+            binaryen.i32,
+            binaryen.i32,
+        ]),
+        binaryen.i32,
+    );
 }
 
 export function generateGlobalContext(module: binaryen.Module) {
@@ -481,16 +512,6 @@ export function generateGlobalJSObject(module: binaryen.Module, name: string) {
     );
 }
 
-export function generateExtRefTableMaskArr(module: binaryen.Module) {
-    const name = getBuiltInFuncName(BuiltinNames.extRefTableMaskArr);
-    module.addGlobal(
-        name,
-        charArrayTypeInfo.typeRef,
-        true,
-        module.ref.null(dyntype.dyn_ctx_t),
-    );
-}
-
 export function generateDynContext(module: binaryen.Module) {
     const initDynContextStmt = module.global.set(
         dyntype.dyntype_context,
@@ -60,15 +60,9 @@ function anyrefCond(module: binaryen.Module) {
         [dynCtx, ref],
         dyntype.bool,
     );
-    const index = module.call(
+    const extRef = module.call(
         dyntype.dyntype_to_extref,
         [dynCtx, ref],
-        dyntype.int,
-    );
-    const extRef = binaryenCAPI._BinaryenTableGet(
-        module.ptr,
-        UtilFuncs.getCString(BuiltinNames.extrefTable),
-        index,
         binaryen.anyref,
     );
 
@@ -1107,95 +1101,6 @@ function string_replace(module: binaryen.Module) {
     return replaceBlock;
 }
 
-function string_replace_stringref(module: binaryen.Module) {
-    const ref_index = 1;
-    const search_str_index = 2;
-    const replace_str_index = 3;
-    const target_pos_index = 4;
-    const search_str_len_index = 5;
-    const ref = module.local.get(
-        ref_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const search_str = module.local.get(
-        search_str_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const replace_str = module.local.get(
-        replace_str_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const target_pos = module.local.get(target_pos_index, binaryen.i32);
-    const search_str_len = module.local.get(search_str_len_index, binaryen.i32);
-    const statementArray: binaryen.ExpressionRef[] = [];
-
-    const pos = module.call(
-        UtilFuncs.getFuncName(
-            BuiltinNames.builtinModuleName,
-            BuiltinNames.stringIndexOfInternalFuncName,
-        ),
-        [
-            module.local.get(0, emptyStructType.typeRef),
-            ref,
-            search_str,
-            module.i32.const(1),
-            module.i32.const(0),
-        ],
-        binaryen.i32,
-    );
-    statementArray.push(module.local.set(target_pos_index, pos));
-    statementArray.push(
-        module.if(
-            module.i32.eq(target_pos, module.i32.const(-1)),
-            module.return(ref),
-        ),
-    );
-    statementArray.push(
-        module.local.set(
-            search_str_len_index,
-            binaryenCAPI._BinaryenStringMeasure(
-                module.ptr,
-                StringRefMeatureOp.WTF16,
-                search_str,
-            ),
-        ),
-    );
-    let res = binaryenCAPI._BinaryenStringConcat(
-        module.ptr,
-        binaryenCAPI._BinaryenStringSliceWTF(
-            module.ptr,
-            StringRefSliceOp.WTF16,
-            binaryenCAPI._BinaryenStringAs(
-                module.ptr,
-                StringRefAsOp.WTF16,
-                ref,
-            ),
-            module.i32.const(0),
-            target_pos,
-        ),
-        replace_str,
-    );
-    res = binaryenCAPI._BinaryenStringConcat(
-        module.ptr,
-        res,
-        binaryenCAPI._BinaryenStringSliceWTF(
-            module.ptr,
-            StringRefSliceOp.WTF16,
-            binaryenCAPI._BinaryenStringAs(
-                module.ptr,
-                StringRefAsOp.WTF16,
-                ref,
-            ),
-            module.i32.add(target_pos, search_str_len),
-            module.i32.const(-1),
-        ),
-    );
-
-    statementArray.push(res);
-
-    return module.block('replace', statementArray);
-}
-
 function string_split(module: binaryen.Module) {
     /** Args: context, this, string*/
     const thisStrStructIdx = 1;
@@ -1448,187 +1353,6 @@ function string_split(module: binaryen.Module) {
     return sliceBlock;
 }
 
-function string_split_stringref(module: binaryen.Module) {
-    const ref_index = 1;
-    const sep_index = 2;
-    const elems_index = 3;
-    const searchBegIdx = 4;
-    const matchIndexIdx = 5;
-    const elems_len_index = 6;
-    const sep_len_index = 7;
-    const remain_str_index = 8;
-    const ref = module.local.get(
-        ref_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const sep = module.local.get(
-        sep_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const elems = module.local.get(
-        elems_index,
-        stringArrayTypeInfoForStringRef.typeRef,
-    );
-    const searchBeg = module.local.get(searchBegIdx, binaryen.i32);
-    const elems_len = module.local.get(elems_len_index, binaryen.i32);
-    const sep_len = module.local.get(sep_len_index, binaryen.i32);
-    const matchIndex = module.local.get(matchIndexIdx, binaryen.i32);
-    const remain_str = module.local.get(
-        remain_str_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const statementArray: binaryen.ExpressionRef[] = [];
-
-    statementArray.push(module.local.set(elems_len_index, module.i32.const(0)));
-    statementArray.push(
-        module.local.set(
-            sep_len_index,
-            binaryenCAPI._BinaryenStringMeasure(
-                module.ptr,
-                StringRefMeatureOp.WTF16,
-                sep,
-            ),
-        ),
-    );
-
-    // 1. get array length
-    const block_label_1 = 'block_label_1';
-    const loop_label_1 = 'loop_block_1';
-    const loop_init_1 = module.local.set(searchBegIdx, module.i32.const(0));
-    const loop_stmts_1 = module.block(null, [
-        module.local.set(
-            matchIndexIdx,
-            module.call(
-                UtilFuncs.getFuncName(
-                    BuiltinNames.builtinModuleName,
-                    BuiltinNames.stringIndexOfInternalFuncName,
-                ),
-                [
-                    module.local.get(0, emptyStructType.typeRef),
-                    ref,
-                    sep,
-                    module.i32.const(1),
-                    searchBeg,
-                ],
-                binaryen.i32,
-            ),
-        ),
-        module.local.set(
-            elems_len_index,
-            module.i32.add(elems_len, module.i32.const(1)),
-        ),
-        module.br(
-            block_label_1,
-            module.i32.eq(matchIndex, module.i32.const(-1)),
-        ),
-        module.local.set(searchBegIdx, module.i32.add(matchIndex, sep_len)),
-        module.br(loop_label_1),
-    ]);
-    const loop_1 = module.loop(loop_label_1, loop_stmts_1);
-    const stmts_block_1 = module.block(block_label_1, [loop_init_1, loop_1]);
-    statementArray.push(stmts_block_1);
-
-    // 2. create array
-    statementArray.push(
-        module.local.set(
-            elems_index,
-            binaryenCAPI._BinaryenArrayNew(
-                module.ptr,
-                stringArrayTypeInfoForStringRef.heapTypeRef,
-                elems_len,
-                module.ref.null(binaryenCAPI._BinaryenTypeStringref()),
-            ),
-        ),
-    );
-
-    // 3.split string by sep
-    statementArray.push(module.local.set(remain_str_index, ref));
-    statementArray.push(module.local.set(elems_len_index, module.i32.const(0)));
-
-    const block_label_2 = 'block_label_2';
-    const loop_label_2 = 'loop_block_2';
-    const loop_stmts_2 = module.block(null, [
-        module.local.set(
-            matchIndexIdx,
-            module.call(
-                UtilFuncs.getFuncName(
-                    BuiltinNames.builtinModuleName,
-                    BuiltinNames.stringIndexOfInternalFuncName,
-                ),
-                [
-                    module.local.get(0, emptyStructType.typeRef),
-                    remain_str,
-                    sep,
-                    module.i32.const(1),
-                    module.i32.const(0),
-                ],
-                binaryen.i32,
-            ),
-        ),
-        module.br(
-            block_label_2,
-            module.i32.eq(matchIndex, module.i32.const(-1)),
-        ),
-        binaryenCAPI._BinaryenArraySet(
-            module.ptr,
-            elems,
-            elems_len,
-            binaryenCAPI._BinaryenStringSliceWTF(
-                module.ptr,
-                StringRefSliceOp.WTF16,
-                binaryenCAPI._BinaryenStringAs(
-                    module.ptr,
-                    StringRefAsOp.WTF16,
-                    remain_str,
-                ),
-                module.i32.const(0),
-                matchIndex,
-            ),
-        ),
-        module.local.set(
-            remain_str_index,
-            binaryenCAPI._BinaryenStringSliceWTF(
-                module.ptr,
-                StringRefSliceOp.WTF16,
-                binaryenCAPI._BinaryenStringAs(
-                    module.ptr,
-                    StringRefAsOp.WTF16,
-                    remain_str,
-                ),
-                module.i32.add(matchIndex, sep_len),
-                module.i32.const(-1),
-            ),
-        ),
-        module.local.set(
-            elems_len_index,
-            module.i32.add(elems_len, module.i32.const(1)),
-        ),
-        module.br(loop_label_2),
-    ]);
-
-    const loop_2 = module.loop(loop_label_2, loop_stmts_2);
-    const stmts_block_2 = module.block(block_label_2, [loop_2]);
-    statementArray.push(stmts_block_2);
-    statementArray.push(
-        binaryenCAPI._BinaryenArraySet(
-            module.ptr,
-            elems,
-            elems_len,
-            remain_str,
-        ),
-    );
-    // 4. return array
-    const structArrayRef = binaryenCAPI._BinaryenStructNew(
-        module.ptr,
-        arrayToPtr([elems, module.i32.add(elems_len, module.i32.const(1))]).ptr,
-        2,
-        stringArrayStructTypeInfoForStringRef.heapTypeRef,
-    );
-    statementArray.push(module.return(structArrayRef));
-
-    return module.block('split', statementArray);
-}
-
 function string_indexOf_internal(module: binaryen.Module) {
     /** Args: context, thisStr, pattern, begin Index*/
     const thisStrStructIdx = 1;
@@ -1962,52 +1686,6 @@ function string_indexOf_internal_stringref(module: binaryen.Module) {
     return module.block('indexOf', statementArray);
 }
 
-function string_indexOf_stringref(module: binaryen.Module) {
-    const ref_index = 1;
-    const str_index = 2;
-    const statementArray: binaryen.ExpressionRef[] = [];
-    const index = module.call(
-        UtilFuncs.getFuncName(
-            BuiltinNames.builtinModuleName,
-            BuiltinNames.stringIndexOfInternalFuncName,
-        ),
-        [
-            module.local.get(0, emptyStructType.typeRef),
-            module.local.get(ref_index, binaryenCAPI._BinaryenTypeStringref()),
-            module.local.get(str_index, binaryenCAPI._BinaryenTypeStringref()),
-            module.i32.const(1),
-            module.i32.const(0),
-        ],
-        binaryen.i32,
-    );
-    statementArray.push(module.return(module.f64.convert_s.i32(index)));
-
-    return module.block('indexOf', statementArray);
-}
-
-function string_lastIndexOf_stringref(module: binaryen.Module) {
-    const ref_index = 1;
-    const str_index = 2;
-    const statementArray: binaryen.ExpressionRef[] = [];
-    const index = module.call(
-        UtilFuncs.getFuncName(
-            BuiltinNames.builtinModuleName,
-            BuiltinNames.stringIndexOfInternalFuncName,
-        ),
-        [
-            module.local.get(0, emptyStructType.typeRef),
-            module.local.get(ref_index, binaryenCAPI._BinaryenTypeStringref()),
-            module.local.get(str_index, binaryenCAPI._BinaryenTypeStringref()),
-            module.i32.const(0),
-            module.i32.const(0),
-        ],
-        binaryen.i32,
-    );
-    statementArray.push(module.return(module.f64.convert_s.i32(index)));
-
-    return module.block('indexOf', statementArray);
-}
-
 function string_match(module: binaryen.Module) {
     /**Args: context, this, targetStr */
     const thisStrStructIdx = 1;
@@ -2325,30 +2003,6 @@ function string_search(module: binaryen.Module) {
     return module.block('search', statementArray);
 }
 
-// TODO: Now it works as string.indexOf
-function string_search_stringref(module: binaryen.Module) {
-    const ref_index = 1;
-    const str_index = 2;
-    const statementArray: binaryen.ExpressionRef[] = [];
-    const index = module.call(
-        UtilFuncs.getFuncName(
-            BuiltinNames.builtinModuleName,
-            BuiltinNames.stringIndexOfInternalFuncName,
-        ),
-        [
-            module.local.get(0, emptyStructType.typeRef),
-            module.local.get(ref_index, binaryenCAPI._BinaryenTypeStringref()),
-            module.local.get(str_index, binaryenCAPI._BinaryenTypeStringref()),
-            module.i32.const(1),
-            module.i32.const(0),
-        ],
-        binaryen.i32,
-    );
-    statementArray.push(module.return(module.f64.convert_s.i32(index)));
-
-    return module.block('search', statementArray);
-}
-
 function string_charAt(module: binaryen.Module) {
     const statementArray: binaryen.ExpressionRef[] = [];
 
@@ -2697,18 +2351,10 @@ function string_toLowerCase(module: binaryen.Module) {
     return string_toLowerOrUpperCase_internal(module, true);
 }
 
-function string_toLowerCase_stringref(module: binaryen.Module) {
-    return module.unreachable();
-}
-
 function string_toUpperCase(module: binaryen.Module) {
     return string_toLowerOrUpperCase_internal(module, false);
 }
 
-function string_toUpperCase_stringref(module: binaryen.Module) {
-    return module.unreachable();
-}
-
 function string_toLowerOrUpperCase_internal(
     module: binaryen.Module,
     lower: boolean,
@@ -3106,112 +2752,6 @@ function string_trim(module: binaryen.Module) {
     return trimBlock;
 }
 
-function string_trim_stringref(module: binaryen.Module) {
-    const ref_index = 1;
-    const start_index = 2;
-    const end_index = 3;
-    const len_index = 4;
-    const ref = module.local.get(
-        ref_index,
-        binaryenCAPI._BinaryenTypeStringref(),
-    );
-    const start = module.local.get(start_index, binaryen.i32);
-    const end = module.local.get(end_index, binaryen.i32);
-    const len = module.local.get(len_index, binaryen.i32);
-    const statementArray: binaryen.ExpressionRef[] = [];
-
-    statementArray.push(
-        module.local.set(
-            len_index,
-            binaryenCAPI._BinaryenStringMeasure(
-                module.ptr,
-                StringRefMeatureOp.WTF16,
-                ref,
-            ),
-        ),
-    );
-    statementArray.push(
-        module.if(module.i32.eq(len, module.i32.const(0)), module.return(ref)),
-    );
-    statementArray.push(module.local.set(start_index, module.i32.const(0)));
-    statementArray.push(
-        module.local.set(end_index, module.i32.sub(len, module.i32.const(1))),
-    );
-    let loop_index = 0;
-    const while_loop = (
-        indexRef: binaryenCAPI.ExpressionRef,
-        index: number,
-        boundRef: binaryenCAPI.ExpressionRef,
-        from_start: boolean,
-    ) => {
-        const char = module.call(
-            UtilFuncs.getFuncName(
-                BuiltinNames.builtinModuleName,
-                BuiltinNames.stringcharAtFuncName,
-            ),
-            [
-                module.local.get(0, emptyStructType.typeRef),
-                ref,
-                module.f64.convert_u.i32(indexRef),
-            ],
-            binaryenCAPI._BinaryenTypeStringref(),
-        );
-        const accessBound = from_start
-            ? module.i32.le_u(indexRef, boundRef)
-            : module.i32.ge_u(indexRef, boundRef);
-        const loopLabel = `while_loop_${loop_index++}`;
-        const loopCond = module.i32.and(
-            accessBound,
-            binaryenCAPI._BinaryenStringEq(
-                module.ptr,
-                StringRefEqOp.EQ,
-                char,
-                binaryenCAPI._BinaryenStringConst(
-                    module.ptr,
-                    UtilFuncs.getCString(' '),
-                ),
-            ),
-        );
-        const loopStmts = module.block(null, [
-            module.local.set(
-                index,
-                from_start
-                    ? module.i32.add(indexRef, module.i32.const(1))
-                    : module.i32.sub(indexRef, module.i32.const(1)),
-            ),
-        ]);
-        const flattenLoop: FlattenLoop = {
-            label: loopLabel,
-            condition: loopCond,
-            statements: loopStmts,
-        };
-        return module.loop(
-            loopLabel,
-            FunctionalFuncs.flattenLoopStatement(
-                module,
-                flattenLoop,
-                SemanticsKind.WHILE,
-            ),
-        );
-    };
-    statementArray.push(while_loop(start, start_index, end, true));
-    statementArray.push(while_loop(end, end_index, start, false));
-    statementArray.push(
-        binaryenCAPI._BinaryenStringSliceWTF(
-            module.ptr,
-            StringRefSliceOp.WTF16,
-            binaryenCAPI._BinaryenStringAs(
-                module.ptr,
-                StringRefAsOp.WTF16,
-                ref,
-            ),
-            start,
-            module.i32.add(end, module.i32.const(1)),
-        ),
-    );
-    return module.block('string_trim', statementArray);
-}
-
 function Array_isArray(module: binaryen.Module) {
     /** Args: context, this, any */
     /* workaround: interface's method has the @this param */
@@ -3259,162 +2799,12 @@ function Array_isArray(module: binaryen.Module) {
     return module.block(null, statementArray);
 }
 
-function allocExtRefTableSlot(module: binaryen.Module) {
-    const objIdx = 0;
-    const tableIdx = 1;
-    const loopIdx = 2;
-    const tmpMaskArrIdx = 3;
-
-    const arrName = getBuiltInFuncName(BuiltinNames.extRefTableMaskArr);
-    const maskArr = binaryenCAPI._BinaryenGlobalGet(
-        module.ptr,
-        UtilFuncs.getCString(arrName),
-        charArrayTypeInfo.typeRef,
-    );
-    const newArray = binaryenCAPI._BinaryenArrayNew(
-        module.ptr,
-        charArrayTypeInfo.heapTypeRef,
-        binaryenCAPI._BinaryenTableSize(
-            module.ptr,
-            UtilFuncs.getCString(BuiltinNames.extrefTable),
-        ),
-        module.i32.const(0),
-    );
-    const tableGrow = binaryenCAPI._BinaryenTableGrow(
-        module.ptr,
-        UtilFuncs.getCString(BuiltinNames.extrefTable),
-        FunctionalFuncs.getEmptyRef(module),
-        module.i32.const(BuiltinNames.tableGrowDelta),
-    );
-    const stmts: binaryen.ExpressionRef[] = [];
-    stmts.push(module.local.set(tableIdx, module.i32.const(-1)));
-    stmts.push(module.local.set(loopIdx, module.i32.const(0)));
-    stmts.push(
-        module.if(
-            module.ref.is_null(maskArr),
-            module.block(null, [
-                tableGrow,
-                binaryenCAPI._BinaryenGlobalSet(
-                    module.ptr,
-                    UtilFuncs.getCString(arrName),
-                    newArray,
-                ),
-            ]),
-        ),
-    );
-    const maskArrLen = binaryenCAPI._BinaryenArrayLen(module.ptr, maskArr);
-    const loopBlock = 'look_block';
-    const loopLabel = 'for_loop';
-    const loopBlockStmts: binaryen.ExpressionRef[] = [];
-    const loopStmts: binaryen.ExpressionRef[] = [];
-    const loopCond = module.i32.lt_u(
-        module.local.get(loopIdx, binaryen.i32),
-        maskArrLen,
-    );
-    const ifBlockStmts: binaryen.ExpressionRef[] = [];
-    ifBlockStmts.push(
-        module.if(
-            module.i32.eq(
-                binaryenCAPI._BinaryenArrayGet(
-                    module.ptr,
-                    maskArr,
-                    module.local.get(loopIdx, binaryen.i32),
-                    charArrayTypeInfo.typeRef,
-                    false,
-                ),
-                module.i32.const(0),
-            ),
-            module.block(null, [
-                module.local.set(
-                    tableIdx,
-                    module.local.get(loopIdx, binaryen.i32),
-                ),
-                module.br(loopBlock),
-            ]),
-        ),
-    );
-    loopStmts.push(module.block(null, ifBlockStmts));
-    loopStmts.push(
-        module.local.set(
-            loopIdx,
-            module.i32.add(
-                module.local.get(loopIdx, binaryen.i32),
-                module.i32.const(1),
-            ),
-        ),
-    );
-    loopStmts.push(module.br(loopLabel));
-    loopBlockStmts.push(
-        module.loop(
-            loopLabel,
-            module.if(loopCond, module.block(null, loopStmts)),
-        ),
-    );
-    stmts.push(module.block(loopBlock, loopBlockStmts));
-
-    const ifStmts2: binaryen.ExpressionRef[] = [];
-    ifStmts2.push(tableGrow);
-    ifStmts2.push(module.local.set(tableIdx, maskArrLen));
-    ifStmts2.push(module.local.set(tmpMaskArrIdx, newArray));
-    ifStmts2.push(
-        binaryenCAPI._BinaryenArrayCopy(
-            module.ptr,
-            module.local.get(tmpMaskArrIdx, charArrayTypeInfo.typeRef),
-            module.i32.const(0),
-            maskArr,
-            module.i32.const(0),
-            maskArrLen,
-        ),
-    );
-    ifStmts2.push(
-        binaryenCAPI._BinaryenGlobalSet(
-            module.ptr,
-            UtilFuncs.getCString(arrName),
-            module.local.get(tmpMaskArrIdx, charArrayTypeInfo.typeRef),
-        ),
-    );
-    stmts.push(
-        module.if(
-            module.i32.eq(
-                module.local.get(tableIdx, binaryen.i32),
-                module.i32.const(-1),
-            ),
-            module.block(null, ifStmts2),
-        ),
-    );
-    const tableSetOp = binaryenCAPI._BinaryenTableSet(
-        module.ptr,
-        UtilFuncs.getCString(BuiltinNames.extrefTable),
-        module.local.get(tableIdx, binaryen.i32),
-        module.local.get(objIdx, binaryen.anyref),
-    );
-    stmts.push(tableSetOp);
-    stmts.push(
-        binaryenCAPI._BinaryenArraySet(
-            module.ptr,
-            maskArr,
-            module.local.get(tableIdx, binaryen.i32),
-            module.i32.const(1),
-        ),
-    );
-
-    stmts.push(module.return(module.local.get(tableIdx, binaryen.i32)));
-    return module.block(null, stmts);
-}
-
-/** to extref with runtime getting table index */
+/** to extref holding the object reference directly */
 function newExtRef(module: binaryen.Module) {
     const _context_unused = 0;
     const objTagIdx = 1;
     const objIdx = 2;
 
-    /* alloc table slot */
-    const tableIdx = module.call(
-        getBuiltInFuncName(BuiltinNames.allocExtRefTableSlot),
-        [module.local.get(objIdx, binaryen.anyref)],
-        dyntype.int,
-    );
-
     /* create extref */
     const call = module.call(
         dyntype.dyntype_new_extref,
@@ -3424,7 +2814,7 @@ function newExtRef(module: binaryen.Module) {
                 UtilFuncs.getCString(dyntype.dyntype_context),
                 binaryen.anyref,
             ),
-            tableIdx,
+            module.local.get(objIdx, binaryen.anyref),
             module.local.get(objTagIdx, binaryen.i32),
         ],
         dyntype.dyn_value_t,
@@ -3902,13 +3292,6 @@ export function callBuiltInAPIs(module: binaryen.Module) {
         [],
         anyrefCond(module),
     );
-    module.addFunction(
-        getBuiltInFuncName(BuiltinNames.allocExtRefTableSlot),
-        binaryen.createType([binaryen.anyref]),
-        binaryen.i32,
-        [binaryen.i32, binaryen.i32, charArrayTypeInfo.typeRef],
-        allocExtRefTableSlot(module),
-    );
     module.addFunction(
         getBuiltInFuncName(BuiltinNames.newExtRef),
         binaryen.createType([
@@ -3920,10 +3303,6 @@ export function callBuiltInAPIs(module: binaryen.Module) {
         [],
         newExtRef(module),
     );
-    module.addFunctionExport(
-        getBuiltInFuncName(BuiltinNames.allocExtRefTableSlot),
-        BuiltinNames.allocExtRefTableSlot,
-    );
     module.addFunction(
         UtilFuncs.getFuncName(
             BuiltinNames.builtinModuleName,
@@ -4044,64 +3423,35 @@ export function callBuiltInAPIs(module: binaryen.Module) {
             ],
             string_indexOf_internal_stringref(module),
         );
-        module.addFunction(
-            UtilFuncs.getFuncName(
-                BuiltinNames.builtinModuleName,
-                BuiltinNames.stringIndexOfFuncName,
-            ),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
+        /* searching functions are implemented by the native string
+            library, which reads the string storage directly */
+        addStringMethod(
+            module,
+            'indexOf',
+            BuiltinNames.stringIndexOfFuncName,
+            [binaryenCAPI._BinaryenTypeStringref()],
             binaryen.f64,
-            [],
-            string_indexOf_stringref(module),
         );
-        module.addFunction(
-            UtilFuncs.getFuncName(
-                BuiltinNames.builtinModuleName,
-                BuiltinNames.stringLastIndexOfFuncName,
-            ),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
+        addStringMethod(
+            module,
+            'lastIndexOf',
+            BuiltinNames.stringLastIndexOfFuncName,
+            [binaryenCAPI._BinaryenTypeStringref()],
             binaryen.f64,
-            [],
-            string_lastIndexOf_stringref(module),
         );
-        module.addFunction(
-            getBuiltInFuncName(BuiltinNames.stringtrimFuncName),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
+        addStringMethod(
+            module,
+            'trim',
+            BuiltinNames.stringtrimFuncName,
+            [],
             binaryenCAPI._BinaryenTypeStringref(),
-            [binaryen.i32, binaryen.i32, binaryen.i32],
-            string_trim_stringref(module),
         );
-        module.addFunction(
-            UtilFuncs.getFuncName(
-                BuiltinNames.builtinModuleName,
-                BuiltinNames.stringSplitFuncName,
-            ),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
+        addStringMethod(
+            module,
+            'split',
+            BuiltinNames.stringSplitFuncName,
+            [binaryenCAPI._BinaryenTypeStringref()],
             stringArrayStructTypeInfoForStringRef.typeRef,
-            [
-                stringArrayTypeInfoForStringRef.typeRef,
-                binaryen.i32,
-                binaryen.i32,
-                binaryen.i32,
-                binaryen.i32,
-                binaryenCAPI._BinaryenTypeStringref(),
-            ],
-            string_split_stringref(module),
         );
         module.addFunction(
             UtilFuncs.getFuncName(
@@ -4117,34 +3467,22 @@ export function callBuiltInAPIs(module: binaryen.Module) {
             [binaryen.i32, stringArrayTypeInfoForStringRef.typeRef],
             string_match_stringref(module),
         );
-        module.addFunction(
-            UtilFuncs.getFuncName(
-                BuiltinNames.builtinModuleName,
-                BuiltinNames.stringSearchFuncName,
-            ),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
+        addStringMethod(
+            module,
+            'search',
+            BuiltinNames.stringSearchFuncName,
+            [binaryenCAPI._BinaryenTypeStringref()],
             binaryen.f64,
-            [],
-            string_search_stringref(module),
         );
-        module.addFunction(
-            UtilFuncs.getFuncName(
-                BuiltinNames.builtinModuleName,
-                BuiltinNames.stringReplaceFuncName,
-            ),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
+        addStringMethod(
+            module,
+            'replace',
+            BuiltinNames.stringReplaceFuncName,
+            [
                 binaryenCAPI._BinaryenTypeStringref(),
                 binaryenCAPI._BinaryenTypeStringref(),
-            ]),
+            ],
             binaryenCAPI._BinaryenTypeStringref(),
-            [binaryen.i32, binaryen.i32],
-            string_replace_stringref(module),
         );
         module.addFunction(
             UtilFuncs.getFuncName(
@@ -4175,25 +3513,21 @@ export function callBuiltInAPIs(module: binaryen.Module) {
             [binaryen.i32, binaryen.i32, binaryen.i32],
             string_charCodeAt_stringref(module),
         );
-        module.addFunction(
-            getBuiltInFuncName(BuiltinNames.stringtoLowerCaseFuncName),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
-            binaryenCAPI._BinaryenTypeStringref(),
+        /* case conversion is implemented by the native string library,
+            which converts 8-bit strings a word at a time */
+        addStringMethod(
+            module,
+            'toLowerCase',
+            BuiltinNames.stringtoLowerCaseFuncName,
             [],
-            string_toLowerCase_stringref(module),
-        );
-        module.addFunction(
-            getBuiltInFuncName(BuiltinNames.stringtoUpperCaseFuncName),
-            binaryen.createType([
-                emptyStructType.typeRef,
-                binaryenCAPI._BinaryenTypeStringref(),
-            ]),
             binaryenCAPI._BinaryenTypeStringref(),
+        );
+        addStringMethod(
+            module,
+            'toUpperCase',
+            BuiltinNames.stringtoUpperCaseFuncName,
             [],
-            string_toUpperCase_stringref(module),
+            binaryenCAPI._BinaryenTypeStringref(),
         );
         /** For now, here should enable --enableStringref flag to get prop name
          * through meta
@@ -4636,6 +3970,26 @@ export function callBuiltInAPIs(module: binaryen.Module) {
     );
 }
 
+function addStringMethod(
+    module: binaryen.Module,
+    method: string,
+    funcName: string,
+    paramTypes: binaryen.Type[],
+    returnType: binaryen.Type,
+) {
+    module.addFunctionImport(
+        UtilFuncs.getFuncName(BuiltinNames.builtinModuleName, funcName),
+        'env',
+        `string_${method}`,
+        binaryen.createType([
+            emptyStructType.typeRef,
+            binaryenCAPI._BinaryenTypeStringref(),
+            ...paramTypes,
+        ]),
+        returnType,
+    );
+}
+
 function addArrayMethod(
     module: binaryen.Module,
     method: string,
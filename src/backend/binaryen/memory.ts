@@ -68,7 +68,3 @@ export function initDefaultMemory(
         segments,
     );
 }
-
-export function initDefaultTable(module: binaryen.Module): void {
-    module.addTable(BuiltinNames.extrefTable, 0, -1, binaryen.anyref);
-}
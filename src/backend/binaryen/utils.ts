@@ -812,18 +812,11 @@ export namespace FunctionalFuncs {
         anyExprRef: binaryen.ExpressionRef,
     ) {
         /* unbox to externalRef */
-        const tableIndex = module.call(
+        return module.call(
             dyntype.dyntype_to_extref,
             [getDynContextRef(module), anyExprRef],
-            dyntype.int,
-        );
-        const externalRef = module.table.get(
-            BuiltinNames.extrefTable,
-            tableIndex,
             binaryen.anyref,
         );
-
-        return externalRef;
     }
 
     export function unboxAnyToExtref(
@@ -122,6 +122,7 @@ import { getConfig } from '../../../config/config_mgr.js';
 export class WASMExpressionGen {
     private module: binaryen.Module;
     private wasmTypeGen;
+    private infcAccessSiteCount = 0;
 
     constructor(private wasmCompiler: WASMGen) {
         this.module = this.wasmCompiler.module;
@@ -2060,15 +2061,18 @@ export class WASMExpressionGen {
         if (member.hasSetter) {
             flag = ItableFlag.SETTER;
         }
+        const siteId = this.newInfcAccessSiteId();
         const flagAndIndexRef = this.getPropFlagAndIdxRefFromObj(
             metaRef,
             memberNameRef,
             flag,
+            siteId,
         );
         const propTypeIdRef = this.getPropTypeIdRefFromObj(
             metaRef,
             memberNameRef,
             flag,
+            siteId,
         );
         const propType = member.hasSetter
             ? (member.setter as VarValue).type
@@ -2192,15 +2196,18 @@ export class WASMExpressionGen {
         const metaRef = FunctionalFuncs.getWASMObjectMeta(this.module, thisRef);
         const memberNameRef = this.getStringOffset(member.name);
         const flag = ItableFlag.ALL;
+        const siteId = this.newInfcAccessSiteId();
         const flagAndIndexRef = this.getPropFlagAndIdxRefFromObj(
             metaRef,
             memberNameRef,
             flag,
+            siteId,
         );
         const propTypeIdRef = this.getPropTypeIdRefFromObj(
             metaRef,
             memberNameRef,
             flag,
+            siteId,
         );
         const propType = isSetter
             ? (member.setter as VarValue).type
@@ -2353,14 +2360,26 @@ export class WASMExpressionGen {
         return res;
     }
 
+    /* the meta lookups of an interface access site share an inline cache
+     * in the runtime, identified by the site id */
+    private newInfcAccessSiteId() {
+        return this.infcAccessSiteCount++;
+    }
+
     private getPropFlagAndIdxRefFromObj(
         meta: binaryen.ExpressionRef,
         name: binaryen.ExpressionRef,
         flag: ItableFlag,
+        siteId: number,
     ) {
         return this.module.call(
-            BuiltinNames.findPropertyFlagAndIndex,
-            [meta, name, this.module.i32.const(flag)],
+            structdyn.StructDyn.struct_ic_find_flag_and_index,
+            [
+                this.module.i32.const(siteId),
+                meta,
+                name,
+                this.module.i32.const(flag),
+            ],
             binaryen.i32,
         );
     }
@@ -2369,10 +2388,16 @@ export class WASMExpressionGen {
         meta: binaryen.ExpressionRef,
         name: binaryen.ExpressionRef,
         flag: ItableFlag,
+        siteId: number,
     ) {
         return this.module.call(
-            BuiltinNames.findPropertyType,
-            [meta, name, this.module.i32.const(flag)],
+            structdyn.StructDyn.struct_ic_find_type,
+            [
+                this.module.i32.const(siteId),
+                meta,
+                name,
+                this.module.i32.const(flag),
+            ],
             binaryen.i32,
         );
     }
@@ -3548,15 +3573,18 @@ export class WASMExpressionGen {
             ownerRef,
         );
         const flag = ItableFlag.ALL;
+        const siteId = this.newInfcAccessSiteId();
         const flagAndIndexRef = this.getPropFlagAndIdxRefFromObj(
             metaRef,
             propertyOffset,
             flag,
+            siteId,
         );
         const propTypeIdRef = this.getPropTypeIdRefFromObj(
             metaRef,
             propertyOffset,
             flag,
+            siteId,
         );
         let elemOperation: binaryen.ExpressionRef;
         if (value.kind === SemanticsValueKind.OBJECT_KEY_SET) {
@@ -4454,22 +4482,18 @@ export class WASMExpressionGen {
                     }
                 } else if (target.type.kind == ValueTypeKind.ANY) {
                     const anyArrRef = elemRef;
-                    const propNameRef = this.getStringOffset('length');
-                    // get the length of any array
+                    // get the length of any array without boxing it
                     const arrLenLocal =
                         this.wasmCompiler.currentFuncCtx!.i32Local();
                     const setArrLenStmt = this.module.local.set(
                         arrLenLocal.index,
-                        this.module.i32.trunc_u.f64(
-                            FunctionalFuncs.unboxAnyToBase(
-                                this.module,
-                                FunctionalFuncs.getDynObjProp(
-                                    this.module,
-                                    anyArrRef,
-                                    propNameRef,
-                                ),
-                                ValueTypeKind.NUMBER,
-                            ),
+                        this.module.call(
+                            dyntype.dyntype_get_array_length,
+                            [
+                                FunctionalFuncs.getDynContextRef(this.module),
+                                anyArrRef,
+                            ],
+                            binaryen.i32,
                         ),
                     );
                     statementArray.push(setArrLenStmt);
@@ -108,6 +108,17 @@ export function stringSearch() {
     return idx;
 }
 
+export function stringSearchPattern() {
+    const str: string = "hello world 2024";
+    let idx: number = str.search("o.w");
+    console.log(idx);               // 4
+    idx = str.search("[0-9]+");
+    console.log(idx);               // 12
+    idx = str.search("^world");
+    console.log(idx);               // -1
+    return idx;
+}
+
 export function stringcharAt() {
     const a: string = 'hello world';
     let b: string = a.charAt(0);
@@ -129,3 +129,31 @@ export function dynamicAccessInUnionType() {
     const bbb = obj.x;
     console.log(bbb);
 }
+
+interface I4 {
+    [key: string]: number;
+}
+
+function getByKey(obj: I4, key: string) {
+    return obj[key];
+}
+
+function setByKey(obj: I4, key: string, value: number) {
+    obj[key] = value;
+}
+
+export function computedKeysInOneSite() {
+    const obj: I4 = {
+        x: 1,
+        y: 2,
+        z: 3,
+    };
+    console.log(getByKey(obj, 'x'));
+    console.log(getByKey(obj, 'z'));
+    console.log(getByKey(obj, 'y'));
+    setByKey(obj, 'z', 30);
+    setByKey(obj, 'x', 10);
+    console.log(getByKey(obj, 'z'));
+    console.log(getByKey(obj, 'x'));
+    console.log(getByKey(obj, 'y'));
+}
@@ -91,6 +91,40 @@ const cstringToJsString = (offset) => {
     return string;
 };
 
+/* meta layout: type_id, impl_id, count, then count * (name, flag_and_index, type) */
+const META_FLAG_ALL = 4;
+const metaPropertyCache = new Map();
+
+const findMetaProperty = (meta, name, flag) => {
+    /* name may point to a reused buffer, so key by its contents */
+    const propName = cstringToJsString(name);
+    const key = `${meta}:${propName}:${flag}`;
+    let res = metaPropertyCache.get(key);
+    if (res) {
+        return res;
+    }
+
+    const memView = new DataView(wasmMemory.buffer);
+    const count = memView.getInt32(meta + 8, true);
+    res = { flagAndIndex: -1, type: -1 };
+    for (let i = 0; i < count; i++) {
+        const field = meta + 12 + i * 12;
+        const flagAndIndex = memView.getInt32(field + 4, true);
+        if (
+            cstringToJsString(memView.getInt32(field, true)) === propName &&
+            (flag === META_FLAG_ALL || (flagAndIndex & 0xf) === flag)
+        ) {
+            res = {
+                flagAndIndex: flagAndIndex,
+                type: memView.getInt32(field + 8, true),
+            };
+            break;
+        }
+    }
+    metaPropertyCache.set(key, res);
+    return res;
+};
+
 const importObject = {
     libstruct_indirect: {
         struct_get_indirect_i32: (obj, index) => {},
@@ -105,6 +139,10 @@ const importObject = {
         struct_set_indirect_f64: (obj, index, value) => {},
         struct_set_indirect_anyref: (obj, index, value) => {},
         struct_set_indirect_funcref: (obj, index, value) => {},
+        struct_ic_find_flag_and_index: (siteId, meta, name, flag) =>
+            findMetaProperty(meta, name, flag).flagAndIndex,
+        struct_ic_find_type: (siteId, meta, name, flag) =>
+            findMetaProperty(meta, name, flag).type,
     },
     libdyntype: {
         dyntype_context_init: () => BigInt(0),
@@ -163,6 +201,9 @@ const importObject = {
         dyntype_get_elem: (ctx, arr, idx) => {
             return arr[idx];
         },
+        dyntype_get_array_length: (ctx, arr) => {
+            return Number.isInteger(arr.length) ? arr.length : -2;
+        },
         dyntype_typeof: (ctx, value) => {
             let res;
             const tag = value[TAG_PROPERTY];
@@ -364,6 +405,16 @@ const importObject = {
         array_includes_f32: () => {},
         array_includes_i32: () => {},
         array_includes_anyref: () => {},
+        string_indexOf: (ctx, str, search) => str.indexOf(search),
+        string_lastIndexOf: (ctx, str, search) => str.lastIndexOf(search),
+        string_search: (ctx, str, pattern) => str.search(pattern),
+        string_replace: (ctx, str, search, replacement) =>
+            str.replace(search, () => replacement),
+        /* the result is a wasm array, which can't be created from JS */
+        string_split: () => {},
+        string_toLowerCase: (ctx, str) => str.toLowerCase(),
+        string_toUpperCase: (ctx, str) => str.toUpperCase(),
+        string_trim: (ctx, str) => str.trim(),
     },
 };
 